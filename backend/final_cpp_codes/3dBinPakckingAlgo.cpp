@@ -7,28 +7,36 @@
 #include <queue>
 #include <cmath>
 #include <unordered_set>
+#include "geometryKernel.hpp"
 
 using namespace std;
+
+// All coordinates and dimensions are fixed-point (see geometryKernel.hpp) and converted back to
+// input units only when written out
 struct Position {
-    int x, y, z;  
-    Position(int _x = 0, int _y = 0, int _z = 0) : x(_x), y(_y), z(_z) {}
+    geom::Coord x, y, z;  
+    Position(geom::Coord _x = 0, geom::Coord _y = 0, geom::Coord _z = 0) : x(_x), y(_y), z(_z) {}
 };
 
 struct Item {
     string id;
     string name;
-    int width, depth, height;
+    geom::Coord width, depth, height;
     int priority;
     string expiryDate;
     int usageLimit;
     string preferredZone;
     int priorityScore;
     
-    int volume() const { return width * depth * height; }
+    geom::Volume volume() const { return geom::FixedBox(0, 0, 0, width, depth, height).volume(); }
+
+    geom::FixedBox boxAt(const Position& pos) const {
+        return geom::FixedBox(pos.x, pos.y, pos.z, width, depth, height);
+    }
 
     Item(){}
     
-    Item(string _id, string _name, int w, int d, int h, int p, 
+    Item(string _id, string _name, geom::Coord w, geom::Coord d, geom::Coord h, int p, 
          string exp, int usage, string zone, int score) 
         : id(_id), name(_name), width(w), depth(d), height(h), 
           priority(p), expiryDate(exp), usageLimit(usage), preferredZone(zone), priorityScore(score) {}
@@ -37,38 +45,40 @@ struct Item {
 struct Container {
     string id;
     string zone;
-    int width, depth, height;
+    geom::Coord width, depth, height;
     
-    int volume() const { return width * depth * height; }
+    geom::Volume volume() const { return geom::FixedBox(0, 0, 0, width, depth, height).volume(); }
     
-    Container(string _id, string _zone, int w, int d, int h) 
+    Container(string _id, string _zone, geom::Coord w, geom::Coord d, geom::Coord h) 
         : id(_id), zone(_zone), width(w), depth(d), height(h) {}
 };
 
 struct finalContainer {
     string id;
     string zone;
-    int width, depth, height;
+    geom::Coord width, depth, height;
     unordered_set<string> itemIds;
 
     finalContainer() {}
 
-    finalContainer(string _id, string _zone, int w, int d, int h, 
+    finalContainer(string _id, string _zone, geom::Coord w, geom::Coord d, geom::Coord h, 
                   const unordered_set<string>& _itemIds) 
         : id(_id), zone(_zone), 
-          width(max(1, w)), // Prevent zero dimensions
-          depth(max(1, d)), 
-          height(max(1, h)), 
+          width(max<geom::Coord>(1, w)), // Prevent zero dimensions
+          depth(max<geom::Coord>(1, d)), 
+          height(max<geom::Coord>(1, h)), 
           itemIds(_itemIds) {} // Fixed: was using itemIds instead of _itemIds
 };
 
 struct FreeSpace {
-    int x, y, z; 
-    int width, depth, height;
+    geom::Coord x, y, z; 
+    geom::Coord width, depth, height;
     
-    int volume() const { return width * depth * height; }
+    geom::FixedBox box() const { return geom::FixedBox(x, y, z, width, depth, height); }
+
+    geom::Volume volume() const { return box().volume(); }
     
-    FreeSpace(int _x, int _y, int _z, int w, int d, int h) 
+    FreeSpace(geom::Coord _x, geom::Coord _y, geom::Coord _z, geom::Coord w, geom::Coord d, geom::Coord h) 
         : x(_x), y(_y), z(_z), width(w), depth(d), height(h) {}
     
     bool fits(const Item& item) const {
@@ -92,8 +102,8 @@ struct FreeSpace {
         }
         
         if (fits(item) && other.fits(item)) {
-            int thisWaste = volume() - item.volume();
-            int otherWaste = other.volume() - item.volume();
+            geom::Volume thisWaste = volume() - item.volume();
+            geom::Volume otherWaste = other.volume() - item.volume();
             // cout << "Both FreeSpaces fit the item. This FreeSpace waste: " << thisWaste 
             //      << ", Other FreeSpace waste: " << otherWaste << endl;
             return thisWaste < otherWaste;
@@ -158,8 +168,8 @@ struct ContainerState {
         freeSpaces.push_back(FreeSpace(0, 0, 0, c.width, c.depth, c.height));
     }
 
-    int usedVolume() const {
-        int total = 0;
+    geom::Volume usedVolume() const {
+        geom::Volume total = 0;
         for (const auto& p : placedItems) {
             total += p.first.volume();
         }
@@ -167,8 +177,8 @@ struct ContainerState {
         return total;
     }
 
-    int freeVolume() const {
-        int freeVol = container.volume() - usedVolume();
+    geom::Volume freeVolume() const {
+        geom::Volume freeVol = container.volume() - usedVolume();
         // cout << "Free volume in container " << container.id << ": " << freeVol << endl;
         return freeVol;
     }
@@ -354,16 +364,7 @@ struct ContainerState {
     }
     
     bool isContained(const FreeSpace& a, const FreeSpace& b) const {
-        bool contained = (a.x >= b.x && a.y >= b.y && a.z >= b.z &&
-                          a.x + a.width <= b.x + b.width &&
-                          a.y + a.depth <= b.y + b.depth &&
-                          a.z + a.height <= b.z + b.height);
-        if (contained) {
-            cout << "FreeSpace at (" << a.x << ", " << a.y << ", " << a.z 
-                 << ") is contained within FreeSpace at (" << b.x << ", " << b.y 
-                 << ", " << b.z << ")" << endl;
-        }
-        return contained;
+        return b.box().contains(a.box());
     }
     
     bool isAccessible(const Position& pos, const Item& item) const {
@@ -372,18 +373,14 @@ struct ContainerState {
             //      << ") is accessible because it is on the ground." << endl;
             return true;
         }
+        geom::FixedBox target = item.boxAt(pos);
         for (const auto& p : placedItems) {
             const Item& placedItem = p.first;
             const Position& placedPos = p.second;
             
             if (placedPos.x == pos.x && placedPos.y == pos.y && placedPos.z == pos.z) continue;
             
-            if (placedPos.x < pos.x + item.width && placedPos.x + placedItem.width > pos.x &&
-                placedPos.z < pos.z + item.height && placedPos.z + placedItem.height > pos.z &&
-                placedPos.y < pos.y) {
-                cout << "Item at position (" << pos.x << ", " << pos.y << ", " << pos.z 
-                     << ") is not accessible due to blocking item at position (" 
-                     << placedPos.x << ", " << placedPos.y << ", " << placedPos.z << ")" << endl;
+            if (placedItem.boxAt(placedPos).blocks(target)) {
                 return false;
             }
         }
@@ -393,6 +390,23 @@ struct ContainerState {
         return true;
     }
     
+    // Blocker count of every placed item in one sweep; retrievalSteps() answers the same for one item
+    unordered_map<string, int> blockerCounts() const {
+        vector<geom::FixedBox> boxes;
+        boxes.reserve(placedItems.size());
+        for (const auto& [item, pos] : placedItems) {
+            boxes.push_back(item.boxAt(pos));
+        }
+        
+        vector<int> blockers = geom::countBlockers(boxes);
+        unordered_map<string, int> counts;
+        counts.reserve(placedItems.size());
+        for (size_t i = 0; i < placedItems.size(); ++i) {
+            counts[placedItems[i].first.id] = blockers[i];
+        }
+        return counts;
+    }
+    
     int retrievalSteps(const string& itemId) const {
         // cout << "Calculating retrieval steps for item " << itemId << " in container " 
         //      << container.id << endl;
@@ -408,15 +422,14 @@ struct ContainerState {
                 }
                 
                 int steps = 0;
+                geom::FixedBox target = item.boxAt(pos);
                 for (const auto& p : placedItems) {
                     const Item& placedItem = p.first;
                     const Position& placedPos = p.second;
                     
                     if (placedItem.id == itemId) continue;
                     
-                    if (placedPos.x < pos.x + item.width && placedPos.x + placedItem.width > pos.x &&
-                        placedPos.z < pos.z + item.height && placedPos.z + placedItem.height > pos.z &&
-                        placedPos.y < pos.y) {
+                    if (placedItem.boxAt(placedPos).blocks(target)) {
                         // cout << "Item " << placedItem.id << " at position (" << placedPos.x 
                         //      << ", " << placedPos.y << ", " << placedPos.z 
                         //      << ") blocks retrieval of item " << itemId << endl;
@@ -527,6 +540,11 @@ using json = nlohmann::json;
 
 using namespace std;
 
+// Fixed-point position back to input units for the JSON output
+json toInputCoordinates(const Position& pos) {
+    return {geom::Fixed::toInput(pos.x), geom::Fixed::toInput(pos.y), geom::Fixed::toInput(pos.z)};
+}
+
 int main() {
     // int noContainers;
     // cout<<"Enter Number of Containers";
@@ -599,9 +617,9 @@ int main() {
     for (const auto& itemData : itemsData) {
         string id = itemData["itemId"];
         string name = itemData["name"];
-        int width = itemData["width"];
-        int depth = itemData["depth"];
-        int height = itemData["height"];
+        geom::Coord width = geom::Fixed::fromInput(itemData["width"].get<double>());
+        geom::Coord depth = geom::Fixed::fromInput(itemData["depth"].get<double>());
+        geom::Coord height = geom::Fixed::fromInput(itemData["height"].get<double>());
         int priority = itemData["priority"];
         string expiryDate = itemData["expiryDate"];
         int usageLimit = itemData["usageLimit"];
@@ -614,9 +632,9 @@ int main() {
     for (const auto& containerData : containersData) {
         string id = containerData["containerId"];
         string zone = containerData["zone"];
-        int width = containerData["width"];
-        int depth = containerData["depth"];
-        int height = containerData["height"];
+        geom::Coord width = geom::Fixed::fromInput(containerData["width"].get<double>());
+        geom::Coord depth = geom::Fixed::fromInput(containerData["depth"].get<double>());
+        geom::Coord height = geom::Fixed::fromInput(containerData["height"].get<double>());
 
         containers.push_back(Container(id, zone, width, depth, height));
     }
@@ -644,13 +662,26 @@ int main() {
 
     json output;
 
+    unordered_map<string, unordered_map<string, int>> blockersByContainer;
+    for (const auto& [containerId, state] : containerStates) {
+        blockersByContainer[containerId] = state.blockerCounts();
+    }
+
     output["placements"] = json::array();
     for (const auto& placement : placements) {
         json placementJson;
         placementJson["itemId"] = placement.itemId;
         placementJson["containerId"] = placement.containerId;
-        placementJson["startPos"] = {placement.startPos.x, placement.startPos.y, placement.startPos.z};
-        placementJson["endPos"] = {placement.endPos.x, placement.endPos.y, placement.endPos.z};
+        placementJson["startPos"] = toInputCoordinates(placement.startPos);
+        placementJson["endPos"] = toInputCoordinates(placement.endPos);
+
+        // Items still in place after rearrangement; relocated ones keep no count
+        const auto& blockers = blockersByContainer[placement.containerId];
+        auto it = blockers.find(placement.itemId);
+        if (it != blockers.end()) {
+            placementJson["retrievalSteps"] = it->second;
+            placementJson["accessible"] = it->second == 0;
+        }
 
         output["placements"].push_back(placementJson);
     }
@@ -662,19 +693,11 @@ int main() {
         rearrangementJson["action"] = rearrangement.action;
         rearrangementJson["itemId"] = rearrangement.itemId;
         rearrangementJson["fromContainer"] = rearrangement.fromContainer;
-        rearrangementJson["fromStartCoordinates"] = {rearrangement.fromStartCoordinates.x, 
-                                                     rearrangement.fromStartCoordinates.y, 
-                                                     rearrangement.fromStartCoordinates.z};
-        rearrangementJson["fromEndCoordinates"] = {rearrangement.fromEndCoordinates.x, 
-                                                   rearrangement.fromEndCoordinates.y, 
-                                                   rearrangement.fromEndCoordinates.z};
+        rearrangementJson["fromStartCoordinates"] = toInputCoordinates(rearrangement.fromStartCoordinates);
+        rearrangementJson["fromEndCoordinates"] = toInputCoordinates(rearrangement.fromEndCoordinates);
         rearrangementJson["toContainer"] = rearrangement.toContainer;
-        rearrangementJson["toStartCoordinates"] = {rearrangement.toStartCoordinates.x, 
-                                                   rearrangement.toStartCoordinates.y, 
-                                                   rearrangement.toStartCoordinates.z};
-        rearrangementJson["toEndCoordinates"] = {rearrangement.toEndCoordinates.x, 
-                                                 rearrangement.toEndCoordinates.y, 
-                                                 rearrangement.toEndCoordinates.z};
+        rearrangementJson["toStartCoordinates"] = toInputCoordinates(rearrangement.toStartCoordinates);
+        rearrangementJson["toEndCoordinates"] = toInputCoordinates(rearrangement.toEndCoordinates);
 
         output["rearrangements"].push_back(rearrangementJson);
     }
@@ -684,9 +707,9 @@ int main() {
         json finalContainerJson;
         finalContainerJson["containerId"] = finalContainer.id;
         finalContainerJson["zone"] = finalContainer.zone;
-        finalContainerJson["width"] = finalContainer.width;
-        finalContainerJson["depth"] = finalContainer.depth;
-        finalContainerJson["height"] = finalContainer.height;
+        finalContainerJson["width"] = geom::Fixed::toInput(finalContainer.width);
+        finalContainerJson["depth"] = geom::Fixed::toInput(finalContainer.depth);
+        finalContainerJson["height"] = geom::Fixed::toInput(finalContainer.height);
         finalContainerJson["itemIds"] = json::array();
 
         for (const auto& itemId : finalContainer.itemIds) {
@@ -0,0 +1,393 @@
+#ifndef GEOMETRY_KERNEL_HPP
+#define GEOMETRY_KERNEL_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// Fixed-point integer geometry shared by the packing, placement, retrieval and waste engines.
+// Coordinates are integer multiples of 1/UnitsPerInput of the input unit (centimetres), so
+// overlap tests and volume math are exact and never need epsilon comparisons.
+
+#ifndef GEOMETRY_UNITS_PER_INPUT
+#define GEOMETRY_UNITS_PER_INPUT 10 // centimetre input, millimetre storage
+#endif
+
+namespace geom {
+
+template <typename CoordT, typename VolumeT, int UnitsPerInput>
+struct FixedPoint {
+    using Coord = CoordT;
+    using Volume = VolumeT;
+
+    static constexpr int unitsPerInput = UnitsPerInput;
+
+    static Coord fromInput(double value) {
+        return static_cast<Coord>(std::llround(value * UnitsPerInput));
+    }
+
+    static constexpr double toInput(Coord value) {
+        return static_cast<double>(value) / UnitsPerInput;
+    }
+
+    static constexpr double volumeToInput(Volume value) {
+        return static_cast<double>(value) / (static_cast<double>(UnitsPerInput) * UnitsPerInput * UnitsPerInput);
+    }
+
+    // Whole input-unit cells covering a fixed-point span [lo, hi)
+    static constexpr Coord cellFloor(Coord value) {
+        return value >= 0 ? value / UnitsPerInput : -((-value + UnitsPerInput - 1) / UnitsPerInput);
+    }
+
+    static constexpr Coord cellCeil(Coord value) {
+        return -cellFloor(-value);
+    }
+};
+
+template <typename FP>
+struct Box {
+    using Coord = typename FP::Coord;
+    using Volume = typename FP::Volume;
+
+    // Corner nearest the origin; y is the depth measured from the open face
+    Coord x, y, z;
+    Coord width, depth, height;
+
+    constexpr Box() : x(0), y(0), z(0), width(0), depth(0), height(0) {}
+
+    constexpr Box(Coord _x, Coord _y, Coord _z, Coord w, Coord d, Coord h)
+        : x(_x), y(_y), z(_z), width(w), depth(d), height(h) {}
+
+    static Box fromInput(double x, double y, double z, double w, double d, double h) {
+        return Box(FP::fromInput(x), FP::fromInput(y), FP::fromInput(z),
+                   FP::fromInput(w), FP::fromInput(d), FP::fromInput(h));
+    }
+
+    static Box fromCorners(Coord x1, Coord y1, Coord z1, Coord x2, Coord y2, Coord z2) {
+        return Box(x1, y1, z1, x2 - x1, y2 - y1, z2 - z1);
+    }
+
+    constexpr Coord maxX() const { return x + width; }
+    constexpr Coord maxY() const { return y + depth; }
+    constexpr Coord maxZ() const { return z + height; }
+
+    constexpr Volume volume() const {
+        return static_cast<Volume>(width) * depth * height;
+    }
+
+    // Boxes that only share a face do not overlap
+    constexpr bool overlaps(const Box& other) const {
+        return x < other.maxX() && other.x < maxX() &&
+               y < other.maxY() && other.y < maxY() &&
+               z < other.maxZ() && other.z < maxZ();
+    }
+
+    // Overlap of the projections onto the open (x, z) face
+    constexpr bool overlapsFace(const Box& other) const {
+        return x < other.maxX() && other.x < maxX() &&
+               z < other.maxZ() && other.z < maxZ();
+    }
+
+    // True when this box sits between the open face and `other`, i.e. must move before `other` can
+    constexpr bool blocks(const Box& other) const {
+        return y < other.y && overlapsFace(other);
+    }
+
+    constexpr bool contains(const Box& other) const {
+        return other.x >= x && other.y >= y && other.z >= z &&
+               other.maxX() <= maxX() && other.maxY() <= maxY() && other.maxZ() <= maxZ();
+    }
+
+    constexpr bool containsPoint(Coord px, Coord py, Coord pz) const {
+        return px >= x && px < maxX() && py >= y && py < maxY() && pz >= z && pz < maxZ();
+    }
+
+    // Fits inside a container whose interior spans [0, w) x [0, d) x [0, h)
+    constexpr bool fitsWithin(Coord w, Coord d, Coord h) const {
+        return x >= 0 && y >= 0 && z >= 0 && maxX() <= w && maxY() <= d && maxZ() <= h;
+    }
+};
+
+// Coarse voxel occupancy over a container interior [0, w) x [0, d) x [0, h). Per voxel it counts
+// the boxes touching it and the boxes covering it completely, mirrored as bitmaps with x along the
+// bits of each word. A clear touched bit proves a voxel empty and a set covered bit proves it
+// occupied; Partial answers, and anything outside the grid, need an exact test against the boxes.
+template <typename FP>
+class OccupancyGrid {
+public:
+    using Coord = typename FP::Coord;
+
+    enum class Occupancy { Empty, Occupied, Partial };
+
+    // Upper bound on the voxel count; finer requests are coarsened to stay within it
+    static constexpr size_t maxVoxels = size_t(1) << 22;
+
+    // The requested voxel size, at least one unit, doubled until the grid holds at most maxVoxels
+    static Coord fitVoxelSize(Coord w, Coord d, Coord h, Coord requested) {
+        Coord size = std::max<Coord>(1, requested);
+        while (size_t(cells(w, size)) * cells(d, size) * cells(h, size) > maxVoxels) size *= 2;
+        return size;
+    }
+
+    OccupancyGrid(Coord w, Coord d, Coord h, Coord voxelSize)
+        : voxel(fitVoxelSize(w, d, h, voxelSize)),
+          nx(cells(w)), ny(cells(d)), nz(cells(h)),
+          wordsPerRow((nx + 63) / 64),
+          touchedCount(size_t(nx) * ny * nz, 0), coveredCount(size_t(nx) * ny * nz, 0),
+          touched(size_t(wordsPerRow) * ny * nz, 0), covered(size_t(wordsPerRow) * ny * nz, 0) {}
+
+    void add(const Box<FP>& box) { update(box, 1); }
+    void remove(const Box<FP>& box) { update(box, -1); }
+
+    Occupancy pointState(Coord x, Coord y, Coord z) const {
+        if (x < 0 || y < 0 || z < 0) return Occupancy::Partial;
+        Coord vx = x / voxel, vy = y / voxel, vz = z / voxel;
+        if (vx >= nx || vy >= ny || vz >= nz) return Occupancy::Partial;
+        size_t word = rowIndex(vy, vz) + vx / 64;
+        uint64_t bit = uint64_t(1) << (vx % 64);
+        if (!(touched[word] & bit)) return Occupancy::Empty;
+        return (covered[word] & bit) ? Occupancy::Occupied : Occupancy::Partial;
+    }
+
+    // Empty when no voxel the region reaches is touched, Occupied when a voxel lying wholly inside
+    // the region is covered, Partial otherwise. Scans whole 64-voxel words at a time.
+    Occupancy regionState(const Box<FP>& region) const {
+        Span outer[3], inner[3];
+        bool insideGrid = region.x >= 0 && region.y >= 0 && region.z >= 0 &&
+                          region.maxX() <= nx * voxel && region.maxY() <= ny * voxel && region.maxZ() <= nz * voxel;
+        if (!spans(region, outer, inner)) return insideGrid ? Occupancy::Empty : Occupancy::Partial;
+
+        bool anyTouched = !insideGrid;
+        for (Coord vz = outer[2].lo; vz < outer[2].hi; ++vz) {
+            for (Coord vy = outer[1].lo; vy < outer[1].hi; ++vy) {
+                size_t row = rowIndex(vy, vz);
+                if (!anyTouched && anyBits(touched, row, outer[0])) anyTouched = true;
+                bool innerRow = vy >= inner[1].lo && vy < inner[1].hi && vz >= inner[2].lo && vz < inner[2].hi;
+                if (innerRow && anyBits(covered, row, inner[0])) return Occupancy::Occupied;
+            }
+        }
+        return anyTouched ? Occupancy::Partial : Occupancy::Empty;
+    }
+
+    Coord voxelSize() const { return voxel; }
+
+private:
+    struct Span { Coord lo, hi; };
+
+    Coord voxel;
+    Coord nx, ny, nz;
+    Coord wordsPerRow;
+    std::vector<uint16_t> touchedCount, coveredCount;
+    std::vector<uint64_t> touched, covered;
+
+    static Coord cells(Coord extent, Coord size) {
+        return std::max<Coord>(1, (std::max<Coord>(0, extent) + size - 1) / size);
+    }
+
+    Coord cells(Coord extent) const {
+        return cells(extent, voxel);
+    }
+
+    size_t rowIndex(Coord vy, Coord vz) const {
+        return (size_t(vz) * ny + vy) * wordsPerRow;
+    }
+
+    // Voxel ranges a box reaches (outer) and fully contains (inner), clamped to the grid
+    bool spans(const Box<FP>& box, Span outer[3], Span inner[3]) const {
+        const Coord lo[3] = {box.x, box.y, box.z};
+        const Coord hi[3] = {box.maxX(), box.maxY(), box.maxZ()};
+        const Coord limit[3] = {nx, ny, nz};
+        for (int axis = 0; axis < 3; ++axis) {
+            Coord from = std::max<Coord>(0, lo[axis]);
+            Coord to = hi[axis];
+            if (to <= from) return false;
+            outer[axis] = {std::min(limit[axis], from / voxel), std::min(limit[axis], (to + voxel - 1) / voxel)};
+            inner[axis] = {std::min(limit[axis], (from + voxel - 1) / voxel), std::min(limit[axis], to / voxel)};
+            if (outer[axis].lo >= outer[axis].hi) return false;
+        }
+        return true;
+    }
+
+    bool anyBits(const std::vector<uint64_t>& bits, size_t row, Span span) const {
+        for (Coord vx = span.lo; vx < span.hi;) {
+            Coord wordEnd = std::min<Coord>(span.hi, (vx / 64 + 1) * 64);
+            uint64_t mask = (wordEnd - vx == 64 ? ~uint64_t(0) : ((uint64_t(1) << (wordEnd - vx)) - 1)) << (vx % 64);
+            if (bits[row + vx / 64] & mask) return true;
+            vx = wordEnd;
+        }
+        return false;
+    }
+
+    static void adjust(std::vector<uint16_t>& counts, std::vector<uint64_t>& bits, size_t cell, size_t word,
+                       uint64_t bit, int delta) {
+        counts[cell] = static_cast<uint16_t>(counts[cell] + delta);
+        if (counts[cell]) bits[word] |= bit; else bits[word] &= ~bit;
+    }
+
+    void update(const Box<FP>& box, int delta) {
+        Span outer[3], inner[3];
+        if (!spans(box, outer, inner)) return;
+        for (Coord vz = outer[2].lo; vz < outer[2].hi; ++vz) {
+            for (Coord vy = outer[1].lo; vy < outer[1].hi; ++vy) {
+                size_t row = rowIndex(vy, vz);
+                bool innerRow = vy >= inner[1].lo && vy < inner[1].hi && vz >= inner[2].lo && vz < inner[2].hi;
+                for (Coord vx = outer[0].lo; vx < outer[0].hi; ++vx) {
+                    size_t cell = (size_t(vz) * ny + vy) * nx + vx;
+                    size_t word = row + vx / 64;
+                    uint64_t bit = uint64_t(1) << (vx % 64);
+                    adjust(touchedCount, touched, cell, word, bit, delta);
+                    if (innerRow && vx >= inner[0].lo && vx < inner[0].hi) {
+                        adjust(coveredCount, covered, cell, word, bit, delta);
+                    }
+                }
+            }
+        }
+    }
+};
+
+namespace detail {
+
+// Offline 2D Fenwick tree: built over every point that will ever be inserted, then counts the
+// inserted points with a <= qa and b <= qb in O(log^2 n)
+class DominanceCounter {
+public:
+    explicit DominanceCounter(const std::vector<std::pair<int64_t, int64_t>>& points) {
+        for (const auto& point : points) xs.push_back(point.first);
+        std::sort(xs.begin(), xs.end());
+        xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+        ys.resize(xs.size() + 1);
+        for (const auto& point : points) {
+            for (size_t i = slot(point.first); i <= xs.size(); i += i & (~i + 1)) ys[i].push_back(point.second);
+        }
+        tree.resize(ys.size());
+        for (size_t i = 1; i < ys.size(); ++i) {
+            std::sort(ys[i].begin(), ys[i].end());
+            ys[i].erase(std::unique(ys[i].begin(), ys[i].end()), ys[i].end());
+            tree[i].assign(ys[i].size() + 1, 0);
+        }
+    }
+
+    void insert(int64_t a, int64_t b) {
+        for (size_t i = slot(a); i <= xs.size(); i += i & (~i + 1)) {
+            size_t j = std::lower_bound(ys[i].begin(), ys[i].end(), b) - ys[i].begin() + 1;
+            for (; j < tree[i].size(); j += j & (~j + 1)) ++tree[i][j];
+        }
+    }
+
+    int count(int64_t qa, int64_t qb) const {
+        int total = 0;
+        for (size_t i = std::upper_bound(xs.begin(), xs.end(), qa) - xs.begin(); i > 0; i -= i & (~i + 1)) {
+            size_t j = std::upper_bound(ys[i].begin(), ys[i].end(), qb) - ys[i].begin();
+            for (; j > 0; j -= j & (~j + 1)) total += tree[i][j];
+        }
+        return total;
+    }
+
+private:
+    std::vector<int64_t> xs;
+    std::vector<std::vector<int64_t>> ys;
+    std::vector<std::vector<int>> tree;
+
+    size_t slot(int64_t a) const {
+        return std::lower_bound(xs.begin(), xs.end(), a) - xs.begin() + 1;
+    }
+};
+
+} // namespace detail
+
+// For every box, how many other boxes block it (Box::blocks), in one sweep from the open face.
+// Boxes are visited in order of y and each is counted against the face rectangles of the boxes
+// strictly in front of it: overlapping = inserted - (left + right + below + above) + the four
+// corner pairs, since the four side conditions only combine across axes. Sides come from 1D and
+// corners from 2D Fenwick trees, so a whole container costs O(n log^2 n) instead of O(n^2).
+// Boxes with a zero face extent break that exclusivity and are counted pairwise instead.
+template <typename FP>
+std::vector<int> countBlockers(const std::vector<Box<FP>>& boxes) {
+    const size_t n = boxes.size();
+    std::vector<int> blockers(n, 0);
+    auto degenerate = [&](size_t i) { return boxes[i].width <= 0 || boxes[i].height <= 0; };
+
+    // Each condition "r lies entirely on one side of q" as a dominance query on a point of r
+    std::vector<std::pair<int64_t, int64_t>> left, right, below, above, leftBelow, leftAbove, rightBelow, rightAbove;
+    for (size_t i = 0; i < n; ++i) {
+        if (degenerate(i)) continue;
+        const Box<FP>& r = boxes[i];
+        int64_t x1 = r.x, x2 = r.maxX(), z1 = r.z, z2 = r.maxZ();
+        left.push_back({x2, 0});
+        right.push_back({-x1, 0});
+        below.push_back({z2, 0});
+        above.push_back({-z1, 0});
+        leftBelow.push_back({x2, z2});
+        leftAbove.push_back({x2, -z1});
+        rightBelow.push_back({-x1, z2});
+        rightAbove.push_back({-x1, -z1});
+    }
+    detail::DominanceCounter leftCount(left), rightCount(right), belowCount(below), aboveCount(above),
+        leftBelowCount(leftBelow), leftAboveCount(leftAbove), rightBelowCount(rightBelow), rightAboveCount(rightAbove);
+
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return boxes[a].y < boxes[b].y; });
+
+    int inserted = 0;
+    for (size_t begin = 0; begin < n;) {
+        size_t end = begin;
+        while (end < n && boxes[order[end]].y == boxes[order[begin]].y) ++end;
+
+        // Query the whole group of equal y before inserting any of it, since blocking needs a smaller y
+        for (size_t k = begin; k < end; ++k) {
+            size_t i = order[k];
+            if (degenerate(i)) continue;
+            const Box<FP>& q = boxes[i];
+            int64_t x1 = q.x, x2 = q.maxX(), z1 = q.z, z2 = q.maxZ();
+            int sides = leftCount.count(x1, 0) + rightCount.count(-x2, 0) +
+                        belowCount.count(z1, 0) + aboveCount.count(-z2, 0);
+            int corners = leftBelowCount.count(x1, z1) + leftAboveCount.count(x1, -z2) +
+                          rightBelowCount.count(-x2, z1) + rightAboveCount.count(-x2, -z2);
+            blockers[i] = inserted - sides + corners;
+        }
+        for (size_t k = begin; k < end; ++k) {
+            size_t i = order[k];
+            if (degenerate(i)) continue;
+            const Box<FP>& r = boxes[i];
+            int64_t x1 = r.x, x2 = r.maxX(), z1 = r.z, z2 = r.maxZ();
+            leftCount.insert(x2, 0);
+            rightCount.insert(-x1, 0);
+            belowCount.insert(z2, 0);
+            aboveCount.insert(-z1, 0);
+            leftBelowCount.insert(x2, z2);
+            leftAboveCount.insert(x2, -z1);
+            rightBelowCount.insert(-x1, z2);
+            rightAboveCount.insert(-x1, -z1);
+            ++inserted;
+        }
+        begin = end;
+    }
+
+    for (size_t d = 0; d < n; ++d) {
+        if (!degenerate(d)) continue;
+        for (size_t j = 0; j < n; ++j) {
+            if (j == d) continue;
+            if (boxes[j].blocks(boxes[d])) ++blockers[d];
+            if (!degenerate(j) && boxes[d].blocks(boxes[j])) ++blockers[j];
+        }
+    }
+    return blockers;
+}
+
+using Fixed = FixedPoint<int32_t, int64_t, GEOMETRY_UNITS_PER_INPUT>;
+using Coord = Fixed::Coord;
+using Volume = Fixed::Volume;
+using FixedBox = Box<Fixed>;
+using FixedOccupancyGrid = OccupancyGrid<Fixed>;
+
+// For engines whose dimensions are already whole input units
+using InputUnits = FixedPoint<int32_t, int64_t, 1>;
+using InputBox = Box<InputUnits>;
+
+} // namespace geom
+
+#endif
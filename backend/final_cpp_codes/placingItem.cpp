@@ -8,6 +8,12 @@
 #include <set>
 #include <limits>
 #include <chrono>
+#include <thread>
+#include <memory>
+#include <optional>
+#include <array>
+#include "geometryKernel.hpp"
+#include "threadPool.hpp"
 
 using namespace std;
 using namespace std::chrono;
@@ -33,15 +39,64 @@ struct Item {
     string expiryDate;
     int usageLimit;
     string preferredZone;
-    // Pre-computed volume for faster sorting and comparison
-    double volume;
+    // Fixed-point dimensions anchored at the origin, and the exact volume derived from them
+    geom::FixedBox extent;
+    geom::Volume volume;
 
     Item() : width(0), depth(0), height(0), priority(0), usageLimit(0), volume(0) {}
 
     Item(string _id, string _name, double w, double d, double h, int p, string ed, int ul, string pz)
         : itemId(_id), name(_name), width(w), depth(d), height(h), 
           priority(p), expiryDate(ed), usageLimit(ul), preferredZone(pz) {
-        volume = w * d * h; // Pre-compute volume
+        extent = geom::FixedBox::fromInput(0, 0, 0, w, d, h);
+        volume = extent.volume(); // Pre-compute volume
+    }
+};
+
+// Occupancy grid over the boxes placed in one container. sync brings it in step with the current
+// layout, adding and removing only the boxes that changed since the previous sync.
+class PlacementGrid {
+public:
+    PlacementGrid(const geom::FixedBox& bounds, geom::Coord voxelSize)
+        : grid(bounds.width, bounds.depth, bounds.height, voxelSize) {}
+
+    void sync(const vector<geom::FixedBox>& boxes) {
+        vector<BoxKey> current;
+        current.reserve(boxes.size());
+        for (const auto& box : boxes) current.push_back(key(box));
+        sort(current.begin(), current.end());
+
+        // Merge the two sorted lists: boxes only in the grid leave it, boxes only in the layout join it
+        size_t i = 0, j = 0;
+        while (i < inGrid.size() || j < current.size()) {
+            if (j == current.size() || (i < inGrid.size() && inGrid[i] < current[j])) {
+                grid.remove(toBox(inGrid[i++]));
+            } else if (i == inGrid.size() || current[j] < inGrid[i]) {
+                grid.add(toBox(current[j++]));
+            } else {
+                ++i;
+                ++j;
+            }
+        }
+        inGrid = std::move(current);
+    }
+
+    const geom::FixedOccupancyGrid& occupancy() const {
+        return grid;
+    }
+
+private:
+    using BoxKey = array<geom::Coord, 6>;
+
+    geom::FixedOccupancyGrid grid;
+    vector<BoxKey> inGrid; // boxes currently in the grid, sorted
+
+    static BoxKey key(const geom::FixedBox& box) {
+        return {box.x, box.y, box.z, box.width, box.depth, box.height};
+    }
+
+    static geom::FixedBox toBox(const BoxKey& k) {
+        return geom::FixedBox(k[0], k[1], k[2], k[3], k[4], k[5]);
     }
 };
 
@@ -51,13 +106,17 @@ struct Container {
     double width;
     double depth;
     double height;
-    double totalVolume; // Pre-compute total volume
+    geom::FixedBox bounds;
+    geom::Volume totalVolume; // Pre-compute total volume
+    geom::Coord voxelSize = 0; // when positive, packItem checks spots against an occupancy grid first
+    shared_ptr<PlacementGrid> grid; // built by the first packItem that needs it, synced by the later ones
 
     Container() : width(0), depth(0), height(0), totalVolume(0) {}
 
     Container(string _id, string _zone, double w, double d, double h)
         : containerId(_id), zone(_zone), width(w), depth(d), height(h) {
-        totalVolume = w * d * h; // Pre-compute total volume
+        bounds = geom::FixedBox::fromInput(0, 0, 0, w, d, h);
+        totalVolume = bounds.volume(); // Pre-compute total volume
     }
 };
 
@@ -66,11 +125,19 @@ struct Placement {
     string itemId;
     Position startPos;
     Position endPos;
+    geom::FixedBox box; // Occupied region in fixed-point, used by every overlap test
 
     Placement() {}
 
     Placement(string _containerId, string _itemId, Position _startPos, Position _endPos)
-        : containerId(_containerId), itemId(_itemId), startPos(_startPos), endPos(_endPos) {}
+        : containerId(_containerId), itemId(_itemId), startPos(_startPos), endPos(_endPos),
+          box(toFixedBox(_startPos, _endPos)) {}
+
+    static geom::FixedBox toFixedBox(const Position& start, const Position& end) {
+        return geom::FixedBox::fromCorners(
+            geom::Fixed::fromInput(start.width), geom::Fixed::fromInput(start.depth), geom::Fixed::fromInput(start.height),
+            geom::Fixed::fromInput(end.width), geom::Fixed::fromInput(end.depth), geom::Fixed::fromInput(end.height));
+    }
 };
 
 // Function to find an item by itemId - O(1) complexity
@@ -91,41 +158,26 @@ Container* findContainer(const map<string, Container>& containerMap, const strin
     return nullptr;
 }
 
-// Function to check if a placement is valid - optimized with early returns
-bool isValidPlacement(const Container& container, const Item& item, const Position& startPos, const Position& endPos) {
-    // Early exit checks
-    if (startPos.width < 0 || startPos.depth < 0 || startPos.height < 0) return false;
-    if (endPos.width > container.width || endPos.depth > container.depth || endPos.height > container.height) return false;
-    return true;
+// Function to check if a placement is valid - exact fixed-point bounds check
+bool isValidPlacement(const Container& container, const geom::FixedBox& box) {
+    return box.fitsWithin(container.bounds.width, container.bounds.depth, container.bounds.height);
 }
 
-// Optimized AABB collision detection with early exits
-bool isCollision(const Placement& existingPlacement, const Item& newItem, 
-                 const Position& newStart, const Position& newEnd,
+// AABB collision detection on fixed-point boxes
+bool isCollision(const Placement& existingPlacement, const geom::FixedBox& newBox,
                  const map<string, Item>& itemMap) {
-    // Find the existing item to get its dimensions
-    auto it = itemMap.find(existingPlacement.itemId);
-    if (it == itemMap.end()) return true; // Item not found, consider it a collision
-    
-    const Item& existingItem = it->second;
-    
-    // Early exit tests - using separating axis theorem principle
-    if (newEnd.width <= existingPlacement.startPos.width || 
-        newStart.width >= existingPlacement.endPos.width ||
-        newEnd.depth <= existingPlacement.startPos.depth || 
-        newStart.depth >= existingPlacement.endPos.depth ||
-        newEnd.height <= existingPlacement.startPos.height || 
-        newStart.height >= existingPlacement.endPos.height) {
-        return false; // No collision
-    }
-    
-    // If we reach here, boxes overlap in all three dimensions
-    return true;
+    // Unknown items are treated as occupying their space
+    if (itemMap.find(existingPlacement.itemId) == itemMap.end()) return true;
+
+    return existingPlacement.box.overlaps(newBox);
 }
 
 // Skyline Best-Fit 3D Bin Packing Algorithm - Optimized
+// Safe to call concurrently for different containers: it only reads the shared placements and items.
+// When outWaste is given it receives the empty space left under the chosen spot.
 bool packItem(Container& container, Item& item, vector<Placement>& existingPlacements, 
-              map<string, Item>& itemMap, Position& startPos, Position& endPos) {
+              map<string, Item>& itemMap, Position& startPos, Position& endPos,
+              double* outWaste = nullptr) {
     // First try preferred coordinates if they exist
     if (startPos.width >= 0 && startPos.depth >= 0 && startPos.height >= 0) {
         Position potentialEnd = {
@@ -133,13 +185,14 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
             startPos.depth + item.depth, 
             startPos.height + item.height
         };
+        geom::FixedBox potentialBox = Placement::toFixedBox(startPos, potentialEnd);
 
-        if (isValidPlacement(container, item, startPos, potentialEnd)) {
+        if (isValidPlacement(container, potentialBox)) {
             // Check for collisions with existing placements in this container only
             bool collision = false;
             for (const auto& placement : existingPlacements) {
                 if (placement.containerId == container.containerId) {
-                    if (isCollision(placement, item, startPos, potentialEnd, itemMap)) {
+                    if (isCollision(placement, potentialBox, itemMap)) {
                         collision = true;
                         break;
                     }
@@ -148,6 +201,7 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
             
             if (!collision) {
                 endPos = potentialEnd;
+                if (outWaste) *outWaste = 0;
                 return true; // Preferred placement worked
             }
         }
@@ -166,6 +220,23 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
         }
     }
 
+    // Voxel grid over the known items here, so most spots are settled without the collision scan.
+    // It lives on the container and only the placements changed since the last call touch it.
+    // Unknown items collide with everything, so their presence leaves every spot to the scan.
+    const geom::FixedOccupancyGrid* grid = nullptr;
+    if (container.voxelSize > 0) {
+        bool anyUnknown = any_of(containerPlacements.begin(), containerPlacements.end(),
+                                 [&itemMap](const Placement* p) { return itemMap.find(p->itemId) == itemMap.end(); });
+        if (!anyUnknown) {
+            if (!container.grid) container.grid = make_shared<PlacementGrid>(container.bounds, container.voxelSize);
+            vector<geom::FixedBox> boxes;
+            boxes.reserve(containerPlacements.size());
+            for (const auto* p : containerPlacements) boxes.push_back(p->box);
+            container.grid->sync(boxes);
+            grid = &container.grid->occupancy();
+        }
+    }
+
     // Create a sparse height map using unordered_map for better performance
     using CoordKey = pair<int, int>;
     struct CoordHash {
@@ -181,8 +252,11 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
         auto itemIt = itemMap.find(p->itemId);
         if (itemIt == itemMap.end()) continue;
 
-        for (int x = p->startPos.width; x < p->endPos.width; ++x) {
-            for (int y = p->startPos.depth; y < p->endPos.depth; ++y) {
+        // Every whole cell the box touches, so fractional extents are not truncated away
+        int xEnd = geom::Fixed::cellCeil(p->box.maxX());
+        int yEnd = geom::Fixed::cellCeil(p->box.maxY());
+        for (int x = geom::Fixed::cellFloor(p->box.x); x < xEnd; ++x) {
+            for (int y = geom::Fixed::cellFloor(p->box.y); y < yEnd; ++y) {
                 heightMap[{x, y}] = max(heightMap[{x, y}], p->endPos.height);
             }
         }
@@ -210,14 +284,18 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
                 tryPos.height + item.height
             };
             
-            if (!isValidPlacement(container, item, tryPos, tryEnd)) continue;
+            geom::FixedBox tryBox = Placement::toFixedBox(tryPos, tryEnd);
+            if (!isValidPlacement(container, tryBox)) continue;
             
             // Check for collisions
-            bool collision = false;
-            for (const auto* p : containerPlacements) {
-                if (isCollision(*p, item, tryPos, tryEnd, itemMap)) {
-                    collision = true;
-                    break;
+            auto state = grid ? grid->regionState(tryBox) : geom::FixedOccupancyGrid::Occupancy::Partial;
+            bool collision = state == geom::FixedOccupancyGrid::Occupancy::Occupied;
+            if (state == geom::FixedOccupancyGrid::Occupancy::Partial) {
+                for (const auto* p : containerPlacements) {
+                    if (isCollision(*p, tryBox, itemMap)) {
+                        collision = true;
+                        break;
+                    }
                 }
             }
             
@@ -251,14 +329,394 @@ bool packItem(Container& container, Item& item, vector<Placement>& existingPlace
             startPos.depth + item.depth, 
             startPos.height + item.height
         };
+        if (outWaste) *outWaste = bestWaste;
         return true;
     }
 
     return false; // No suitable placement found
 }
 
+// How rearrangeItems treats placements that already exist
+enum class RearrangeMode {
+    Incremental, // keep existing placements, relocate only what the new items need
+    Full         // clear everything and re-pack all items from scratch
+};
+
+// Upper bound on how many placed items may be displaced to fit one new item
+const int MAX_EVICTIONS_PER_ITEM = 3;
+
+// Bounds on the eviction search for one item: packing attempts and wall-clock time
+const int MAX_EVICTION_ATTEMPTS = 64;
+const int EVICTION_TIME_BUDGET_MS = 1000;
+
+// A single physical change to the station layout, in the same shape as the 3D packer's output
+struct Rearrangement {
+    int step;
+    string action; // "place" for a newly stowed item, "move" for a relocated one
+    string itemId;
+    string fromContainer;
+    Position fromStartCoordinates;
+    Position fromEndCoordinates;
+    string toContainer;
+    Position toStartCoordinates;
+    Position toEndCoordinates;
+
+    Rearrangement() : step(0) {}
+
+    Rearrangement(int _step, string _action, string _itemId, string _fromContainer,
+                  Position _fromStart, Position _fromEnd,
+                  string _toContainer, Position _toStart, Position _toEnd)
+        : step(_step), action(_action), itemId(_itemId), fromContainer(_fromContainer),
+          fromStartCoordinates(_fromStart), fromEndCoordinates(_fromEnd),
+          toContainer(_toContainer), toStartCoordinates(_toStart), toEndCoordinates(_toEnd) {}
+};
+
+// Returns container ids ordered for the given item: preferred zone first, then the rest,
+// each group sorted by utilization (least utilized first)
+vector<string> candidateContainers(const Item& item, const vector<Container>& containers,
+                                   unordered_map<string, geom::Volume>& containerUtilization) {
+    vector<pair<string, double>> preferred, others;
+    preferred.reserve(containers.size());
+    others.reserve(containers.size());
+
+    for (const auto& container : containers) {
+        double utilization = static_cast<double>(containerUtilization[container.containerId]) / container.totalVolume;
+        if (container.zone == item.preferredZone) {
+            preferred.push_back({container.containerId, utilization});
+        } else {
+            others.push_back({container.containerId, utilization});
+        }
+    }
+
+    auto byUtilization = [](const pair<string, double>& a, const pair<string, double>& b) {
+        return a.second < b.second;
+    };
+    sort(preferred.begin(), preferred.end(), byUtilization);
+    sort(others.begin(), others.end(), byUtilization);
+
+    vector<string> ordered;
+    ordered.reserve(containers.size());
+    for (auto& [containerId, _] : preferred) ordered.push_back(containerId);
+    for (auto& [containerId, _] : others) ordered.push_back(containerId);
+    return ordered;
+}
+
+// Evaluates a group of candidate containers on the pool and returns the index of the best fit:
+// least waste under the item, then least utilized container, then candidate order. -1 if none fit.
+int bestContainerInParallel(Item& item, const vector<Container*>& group, const vector<double>& utilization,
+                            vector<Placement>& existingPlacements, map<string, Item>& itemMap,
+                            ThreadPool& pool, vector<Position>& starts, vector<Position>& ends) {
+    vector<double> waste(group.size(), numeric_limits<double>::max());
+    vector<char> fits(group.size(), 0);
+    starts.assign(group.size(), Position());
+    ends.assign(group.size(), Position());
+
+    pool.parallelFor(group.size(), [&](size_t i) {
+        fits[i] = packItem(*group[i], item, existingPlacements, itemMap, starts[i], ends[i], &waste[i]);
+    });
+
+    int best = -1;
+    for (size_t i = 0; i < group.size(); ++i) {
+        if (!fits[i]) continue;
+        if (best < 0 || waste[i] < waste[best] ||
+            (waste[i] == waste[best] && utilization[i] < utilization[best])) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+// Places an item in the first candidate container that can hold it and records the placement.
+// With a pool, each zone group (preferred, then the rest) is evaluated concurrently and the best
+// container of the first group with any fit wins instead of the first one that fits.
+bool placeInAnyContainer(Item& item, vector<Container>& containers, map<string, Container>& containerMap,
+                         unordered_map<string, geom::Volume>& containerUtilization,
+                         vector<Placement>& existingPlacements, map<string, Item>& itemMap,
+                         Placement& outPlacement, ThreadPool* pool = nullptr) {
+    if (pool) {
+        vector<string> ordered = candidateContainers(item, containers, containerUtilization);
+        vector<Container*> preferred, others;
+        vector<double> preferredUtil, othersUtil;
+        for (const auto& containerId : ordered) {
+            Container* container = &containerMap[containerId];
+            double utilization = static_cast<double>(containerUtilization[containerId]) / container->totalVolume;
+            if (container->zone == item.preferredZone) {
+                preferred.push_back(container);
+                preferredUtil.push_back(utilization);
+            } else {
+                others.push_back(container);
+                othersUtil.push_back(utilization);
+            }
+        }
+
+        for (auto [group, utilization] : {make_pair(&preferred, &preferredUtil), make_pair(&others, &othersUtil)}) {
+            vector<Position> starts, ends;
+            int best = bestContainerInParallel(item, *group, *utilization, existingPlacements, itemMap, *pool, starts, ends);
+            if (best < 0) continue;
+
+            const string& containerId = (*group)[best]->containerId;
+            outPlacement = Placement(containerId, item.itemId, starts[best], ends[best]);
+            existingPlacements.push_back(outPlacement);
+            containerUtilization[containerId] += item.volume;
+
+            cerr << "Item " << item.itemId << " placed in container " << containerId
+                 << " at position (" << starts[best].width << ", " << starts[best].depth << ", " << starts[best].height << ")"
+                 << " after evaluating " << group->size() << " container(s) in parallel" << endl;
+            return true;
+        }
+        return false;
+    }
+
+    for (const auto& containerId : candidateContainers(item, containers, containerUtilization)) {
+        Container& container = containerMap[containerId];
+        Position startPos, endPos;
+
+        cerr << "Trying container " << containerId << " (current utilization: "
+             << static_cast<double>(containerUtilization[containerId]) / container.totalVolume * 100 << "%)" << endl;
+
+        if (packItem(container, item, existingPlacements, itemMap, startPos, endPos)) {
+            outPlacement = Placement(containerId, item.itemId, startPos, endPos);
+            existingPlacements.push_back(outPlacement);
+            containerUtilization[containerId] += item.volume;
+
+            cerr << "Item " << item.itemId << " placed in container " << containerId
+                 << " at position (" << startPos.width << ", " << startPos.depth << ", " << startPos.height << ")" << endl;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Makes room for an item by displacing as few placed items as possible. Every combination of one
+// resident is tried in every candidate container before any combination of two, and so on up to
+// MAX_EVICTIONS_PER_ITEM, so the first attempt that works displaces the fewest items. Within a size,
+// combinations follow the least-important-first resident order. An attempt only commits if the new
+// item fits and every evicted item finds a new spot; otherwise the layout is restored untouched.
+// Combinations that cannot free enough volume are skipped without packing; the rest are bounded by
+// MAX_EVICTION_ATTEMPTS and EVICTION_TIME_BUDGET_MS, after which the item is left unplaced.
+bool relocateToFit(Item& item, vector<Container>& containers, map<string, Container>& containerMap,
+                   unordered_map<string, geom::Volume>& containerUtilization,
+                   vector<Placement>& existingPlacements, map<string, Item>& itemMap,
+                   vector<Rearrangement>& moves, ThreadPool* pool = nullptr) {
+    // Eviction candidates per container, cheapest to disturb first
+    vector<string> candidates = candidateContainers(item, containers, containerUtilization);
+    vector<vector<Placement>> residents(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        for (const auto& p : existingPlacements) {
+            if (p.containerId == candidates[c] && itemMap.count(p.itemId)) {
+                residents[c].push_back(p);
+            }
+        }
+        sort(residents[c].begin(), residents[c].end(), [&itemMap](const Placement& a, const Placement& b) {
+            const Item& ia = itemMap[a.itemId];
+            const Item& ib = itemMap[b.itemId];
+            if (ia.priority != ib.priority) return ia.priority < ib.priority;
+            return ia.volume < ib.volume;
+        });
+    }
+
+    auto tryEviction = [&](const string& containerId, const vector<Placement>& evicted) {
+        Container& container = containerMap[containerId];
+        unordered_set<string> evictedIds;
+        for (const auto& p : evicted) evictedIds.insert(p.itemId);
+
+        existingPlacements.erase(remove_if(existingPlacements.begin(), existingPlacements.end(),
+                                           [&evictedIds](const Placement& p) {
+                                               return evictedIds.count(p.itemId) > 0;
+                                           }),
+                                 existingPlacements.end());
+        for (const auto& p : evicted) {
+            containerUtilization[p.containerId] -= itemMap[p.itemId].volume;
+        }
+        size_t committedSize = existingPlacements.size();
+
+        Position startPos, endPos;
+        bool fits = packItem(container, item, existingPlacements, itemMap, startPos, endPos);
+        vector<Placement> relocated;
+        if (fits) {
+            existingPlacements.push_back(Placement(containerId, item.itemId, startPos, endPos));
+            containerUtilization[containerId] += item.volume;
+
+            // The evicted items still occupy their old spots until they are moved out, so their
+            // new spots must stay clear of those as well as of the new item's
+            size_t vacatingBegin = existingPlacements.size();
+            existingPlacements.insert(existingPlacements.end(), evicted.begin(), evicted.end());
+            for (const auto& p : evicted) {
+                Placement newSpot;
+                if (!placeInAnyContainer(itemMap[p.itemId], containers, containerMap,
+                                         containerUtilization, existingPlacements, itemMap, newSpot, pool)) {
+                    fits = false;
+                    break;
+                }
+                relocated.push_back(newSpot);
+            }
+            existingPlacements.erase(existingPlacements.begin() + vacatingBegin,
+                                     existingPlacements.begin() + vacatingBegin + evicted.size());
+        }
+
+        if (fits) {
+            // Clear the way first, then stow the new item
+            for (size_t i = 0; i < evicted.size(); ++i) {
+                moves.push_back(Rearrangement(moves.size() + 1, "move", evicted[i].itemId,
+                                              evicted[i].containerId, evicted[i].startPos, evicted[i].endPos,
+                                              relocated[i].containerId, relocated[i].startPos, relocated[i].endPos));
+            }
+            moves.push_back(Rearrangement(moves.size() + 1, "place", item.itemId, "", Position(), Position(),
+                                          containerId, startPos, endPos));
+            cerr << "Item " << item.itemId << " placed in container " << containerId
+                 << " after relocating " << evicted.size() << " item(s)" << endl;
+            return true;
+        }
+
+        // Roll back this attempt
+        for (size_t i = committedSize; i < existingPlacements.size(); ++i) {
+            containerUtilization[existingPlacements[i].containerId] -= itemMap[existingPlacements[i].itemId].volume;
+        }
+        existingPlacements.resize(committedSize);
+        for (const auto& p : evicted) {
+            existingPlacements.push_back(p);
+            containerUtilization[p.containerId] += itemMap[p.itemId].volume;
+        }
+        return false;
+    };
+
+    // Largest volume any k residents can free, per container: sum of the k largest
+    vector<vector<geom::Volume>> largestFreed(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        vector<geom::Volume> volumes;
+        for (const auto& p : residents[c]) volumes.push_back(itemMap[p.itemId].volume);
+        sort(volumes.rbegin(), volumes.rend());
+        largestFreed[c].assign(1, 0);
+        for (int k = 0; k < MAX_EVICTIONS_PER_ITEM && k < static_cast<int>(volumes.size()); ++k) {
+            largestFreed[c].push_back(largestFreed[c].back() + volumes[k]);
+        }
+    }
+
+    auto deadline = steady_clock::now() + milliseconds(EVICTION_TIME_BUDGET_MS);
+    int attempts = 0;
+    auto budgetSpent = [&]() {
+        if (attempts < MAX_EVICTION_ATTEMPTS && steady_clock::now() < deadline) return false;
+        cerr << "Eviction search for item " << item.itemId << " stopped after " << attempts << " attempt(s)" << endl;
+        return true;
+    };
+
+    for (int k = 1; k <= MAX_EVICTIONS_PER_ITEM; ++k) {
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            int n = residents[c].size();
+            if (n < k) continue;
+
+            const string& containerId = candidates[c];
+            geom::Volume freeVolume = containerMap[containerId].totalVolume - containerUtilization[containerId];
+            if (freeVolume + largestFreed[c][k] < item.volume) continue;
+
+            // Walk the k-combinations of residents in lexicographic index order
+            vector<int> pick(k);
+            for (int i = 0; i < k; ++i) pick[i] = i;
+            while (true) {
+                if (budgetSpent()) return false;
+
+                geom::Volume freed = 0;
+                for (int i : pick) freed += itemMap[residents[c][i].itemId].volume;
+                if (freeVolume + freed >= item.volume) {
+                    vector<Placement> evicted;
+                    evicted.reserve(k);
+                    for (int i : pick) evicted.push_back(residents[c][i]);
+                    ++attempts;
+                    if (tryEviction(containerId, evicted)) return true;
+                }
+
+                int i = k - 1;
+                while (i >= 0 && pick[i] == n - k + i) --i;
+                if (i < 0) break;
+                ++pick[i];
+                for (int j = i + 1; j < k; ++j) pick[j] = pick[j - 1] + 1;
+            }
+        }
+    }
+    return false;
+}
+
+// One entry of the before/after comparison of a layout
+struct PlacementChange {
+    enum Kind { Moved, Unchanged, Removed, Added };
+
+    string itemId;
+    Kind kind;
+    Placement before; // empty for Added
+    Placement after;  // empty for Removed
+
+    const char* kindName() const {
+        switch (kind) {
+            case Moved: return "moved";
+            case Unchanged: return "unchanged";
+            case Removed: return "removed";
+            default: return "added";
+        }
+    }
+};
+
+struct ContainerMoveCount {
+    int in = 0;  // items moved or added into the container
+    int out = 0; // items moved or removed out of the container
+};
+
+struct PlacementDiff {
+    vector<PlacementChange> changes;
+    unordered_map<string, ContainerMoveCount> containerMoves;
+    int moved = 0, unchanged = 0, removed = 0, added = 0;
+};
+
+// Compares two layouts by item id with a hashed lookup. A placement is unchanged when the item stays
+// in the same container with the same fixed-point origin.
+PlacementDiff diffPlacements(const vector<Placement>& before, const vector<Placement>& after) {
+    PlacementDiff diff;
+    diff.changes.reserve(max(before.size(), after.size()));
+
+    unordered_map<string, const Placement*> afterByItem;
+    afterByItem.reserve(after.size());
+    for (const auto& p : after) {
+        afterByItem[p.itemId] = &p;
+    }
+
+    unordered_set<string> seen;
+    seen.reserve(before.size());
+    for (const auto& oldP : before) {
+        seen.insert(oldP.itemId);
+        auto it = afterByItem.find(oldP.itemId);
+        if (it == afterByItem.end()) {
+            diff.changes.push_back({oldP.itemId, PlacementChange::Removed, oldP, Placement()});
+            diff.containerMoves[oldP.containerId].out++;
+            diff.removed++;
+            continue;
+        }
+
+        const Placement& newP = *it->second;
+        bool samePlace = oldP.containerId == newP.containerId &&
+                         oldP.box.x == newP.box.x && oldP.box.y == newP.box.y && oldP.box.z == newP.box.z;
+        if (samePlace) {
+            diff.changes.push_back({oldP.itemId, PlacementChange::Unchanged, oldP, newP});
+            diff.unchanged++;
+        } else {
+            diff.changes.push_back({oldP.itemId, PlacementChange::Moved, oldP, newP});
+            diff.containerMoves[oldP.containerId].out++;
+            diff.containerMoves[newP.containerId].in++;
+            diff.moved++;
+        }
+    }
+
+    for (const auto& newP : after) {
+        if (seen.count(newP.itemId)) continue;
+        diff.changes.push_back({newP.itemId, PlacementChange::Added, Placement(), newP});
+        diff.containerMoves[newP.containerId].in++;
+        diff.added++;
+    }
+
+    return diff;
+}
+
 vector<Placement> rearrangeItems(vector<Item>& items, vector<Container>& containers, 
-                                vector<Placement>& existingPlacements) {
+                                vector<Placement>& existingPlacements, vector<Rearrangement>& moves,
+                                RearrangeMode mode = RearrangeMode::Incremental, ThreadPool* pool = nullptr) {
     vector<Placement> newPlacements;
     newPlacements.reserve(items.size()); // Pre-allocate memory
     
@@ -284,8 +742,8 @@ vector<Placement> rearrangeItems(vector<Item>& items, vector<Container>& contain
         if (a.priority != b.priority)
             return a.priority > b.priority;
         
-        // Use pre-computed volume
-        if (abs(a.volume - b.volume) > 0.01)
+        // Use pre-computed volume (exact integer comparison)
+        if (a.volume != b.volume)
             return a.volume > b.volume;
             
         return a.expiryDate < b.expiryDate;
@@ -296,15 +754,47 @@ vector<Placement> rearrangeItems(vector<Item>& items, vector<Container>& contain
     placedItems.reserve(items.size()); // Pre-allocate
     
     // Map to track container utilization
-    unordered_map<string, double> containerUtilization;
+    unordered_map<string, geom::Volume> containerUtilization;
     containerUtilization.reserve(containers.size()); // Pre-allocate
     for (auto& container : containers) {
-        containerUtilization[container.containerId] = 0.0;
+        containerUtilization[container.containerId] = 0;
+    }
+
+    if (mode == RearrangeMode::Incremental) {
+        // Existing placements stay where they are; only unplaced items are stowed
+        for (const auto& p : existingPlacements) {
+            placedItems.insert(p.itemId);
+            auto it = itemMap.find(p.itemId);
+            if (it != itemMap.end()) {
+                containerUtilization[p.containerId] += it->second.volume;
+            }
+        }
+
+        for (auto& item : sortedItems) {
+            if (placedItems.find(item.itemId) != placedItems.end()) continue;
+
+            cerr << "Processing item: " << item.itemId << " (Priority: " << item.priority << ", Volume: " << geom::Fixed::volumeToInput(item.volume) << ")" << endl;
+
+            Placement newPlacement;
+            if (placeInAnyContainer(item, containers, containerMap, containerUtilization,
+                                    existingPlacements, itemMap, newPlacement, pool)) {
+                moves.push_back(Rearrangement(moves.size() + 1, "place", item.itemId, "", Position(), Position(),
+                                              newPlacement.containerId, newPlacement.startPos, newPlacement.endPos));
+            } else if (!relocateToFit(item, containers, containerMap, containerUtilization,
+                                      existingPlacements, itemMap, moves, pool)) {
+                cerr << "Warning: Item " << item.itemId << " could not be placed during rearrangement." << endl;
+                continue;
+            }
+            placedItems.insert(item.itemId);
+        }
+
+        cerr << "\nIncremental rearrangement: " << moves.size() << " move(s)" << endl;
+        return existingPlacements;
     }
     
     // Clear existing placements but remember the original placement configuration
     vector<Placement> originalPlacements = existingPlacements;
-    cout << "Original placements count: " << originalPlacements.size() << endl;
+    cerr << "Original placements count: " << originalPlacements.size() << endl;
     
     // Clear existing placements before rearrangement
     existingPlacements.clear();
@@ -313,159 +803,36 @@ vector<Placement> rearrangeItems(vector<Item>& items, vector<Container>& contain
     for (auto& item : sortedItems) {
         // Skip if already placed
         if (placedItems.find(item.itemId) != placedItems.end()) {
-            cout << "Item " << item.itemId << " already placed, skipping..." << endl;
+            cerr << "Item " << item.itemId << " already placed, skipping..." << endl;
             continue;
         }
         
-        bool placed = false;
-        
-        cout << "Processing item: " << item.itemId << " (Priority: " << item.priority << ", Volume: " << item.volume << ")" << endl;
-        
-        // First try placing in preferred zone containers
-        vector<pair<string, double>> preferredContainers;
-        preferredContainers.reserve(containers.size()); // Pre-allocate space
-        
-        for (auto& container : containers) {
-            if (container.zone == item.preferredZone) {
-                // Calculate available volume percentage
-                double utilization = containerUtilization[container.containerId] / container.totalVolume;
-                preferredContainers.push_back({container.containerId, utilization});
-            }
-        }
-        
-        // Sort preferred containers by utilization (least utilized first)
-        sort(preferredContainers.begin(), preferredContainers.end(),
-             [](const pair<string, double>& a, const pair<string, double>& b) {
-                 return a.second < b.second;
-             });
-        
-        cout << "Found " << preferredContainers.size() << " preferred containers for zone: " << item.preferredZone << endl;
-        
-        // Try preferred containers first
-        for (auto& [containerId, utilPct] : preferredContainers) {
-            Container& container = containerMap[containerId];
-            Position startPos, endPos;
-            
-            cout << "Trying container " << containerId << " (current utilization: " << utilPct * 100 << "%)" << endl;
-            
-            if (packItem(container, item, existingPlacements, itemMap, startPos, endPos)) {
-                Placement newPlacement{
-                    containerId,
-                    item.itemId,
-                    startPos,
-                    endPos
-                };
-                
-                existingPlacements.push_back(newPlacement);
-                newPlacements.push_back(newPlacement);
-                
-                // Update container utilization
-                containerUtilization[containerId] += item.volume;
-                
-                placedItems.insert(item.itemId);
-                placed = true;
-                
-                cout << "Item " << item.itemId << " placed in preferred container " << containerId 
-                     << " at position (" << startPos.width << ", " << startPos.depth << ", " << startPos.height << ")" << endl;
-                break;
-            }
-        }
-        
-        // If not placed in preferred zone, try any container
-        if (!placed) {
-            cout << "Could not place item " << item.itemId << " in preferred zone. Trying any container..." << endl;
-            
-            // Sort all containers by utilization (least utilized first)
-            vector<pair<string, double>> allContainers;
-            allContainers.reserve(containers.size()); // Pre-allocate space
-            
-            for (auto& container : containers) {
-                double utilization = containerUtilization[container.containerId] / container.totalVolume;
-                allContainers.push_back({container.containerId, utilization});
-            }
-            
-            sort(allContainers.begin(), allContainers.end(),
-                 [](const pair<string, double>& a, const pair<string, double>& b) {
-                     return a.second < b.second;
-                 });
-            
-            // Create a set of preferred container IDs for faster lookup
-            unordered_set<string> preferredContainerIds;
-            for (auto& [containerId, _] : preferredContainers) {
-                preferredContainerIds.insert(containerId);
-            }
-            
-            for (auto& [containerId, utilPct] : allContainers) {
-                // Skip if we already tried this in preferred containers
-                if (preferredContainerIds.find(containerId) != preferredContainerIds.end()) {
-                    continue;
-                }
-                
-                Container& container = containerMap[containerId];
-                Position startPos, endPos;
-                
-                cout << "Trying container " << containerId << " (current utilization: " << utilPct * 100 << "%)" << endl;
-                
-                if (packItem(container, item, existingPlacements, itemMap, startPos, endPos)) {
-                    Placement newPlacement{
-                        containerId,
-                        item.itemId,
-                        startPos,
-                        endPos
-                    };
-                    
-                    existingPlacements.push_back(newPlacement);
-                    newPlacements.push_back(newPlacement);
-                    
-                    // Update container utilization
-                    containerUtilization[containerId] += item.volume;
-                    
-                    placedItems.insert(item.itemId);
-                    placed = true;
-                    
-                    cout << "Item " << item.itemId << " placed in container " << containerId 
-                         << " at position (" << startPos.width << ", " << startPos.depth << ", " << startPos.height << ")" << endl;
-                    break;
-                }
-            }
-        }
+        cerr << "Processing item: " << item.itemId << " (Priority: " << item.priority << ", Volume: " << geom::Fixed::volumeToInput(item.volume) << ")" << endl;
         
-        if (!placed) {
+        Placement newPlacement;
+        if (placeInAnyContainer(item, containers, containerMap, containerUtilization,
+                                existingPlacements, itemMap, newPlacement, pool)) {
+            newPlacements.push_back(newPlacement);
+            placedItems.insert(item.itemId);
+        } else {
             cerr << "Warning: Item " << item.itemId << " could not be placed during rearrangement." << endl;
         }
     }
     
-    // Compare new placements with original
-    cout << "\nPlacement comparison:" << endl;
-    cout << "Original placements: " << originalPlacements.size() << endl;
-    cout << "New placements: " << newPlacements.size() << endl;
-    
-    // Check for changes in item positions
-    for (const auto& oldP : originalPlacements) {
-        bool found = false;
-        for (const auto& newP : newPlacements) {
-            if (oldP.itemId == newP.itemId) {
-                found = true;
-                if (oldP.containerId != newP.containerId ||
-                    oldP.startPos.width != newP.startPos.width ||
-                    oldP.startPos.depth != newP.startPos.depth ||
-                    oldP.startPos.height != newP.startPos.height) {
-                    
-                    cout << "Item " << oldP.itemId << " moved from " 
-                         << oldP.containerId << " (" << oldP.startPos.width << ", " << oldP.startPos.depth << ", " << oldP.startPos.height << ")"
-                         << " to " 
-                         << newP.containerId << " (" << newP.startPos.width << ", " << newP.startPos.depth << ", " << newP.startPos.height << ")" << endl;
-                } else {
-                    cout << "Item " << oldP.itemId << " position unchanged" << endl;
-                }
-                break;
-            }
-        }
-        
-        if (!found) {
-            cout << "Item " << oldP.itemId << " was removed from placement" << endl;
+    // Every item whose spot changed becomes a move, every newly stowed item a place
+    PlacementDiff diff = diffPlacements(originalPlacements, newPlacements);
+    for (const auto& change : diff.changes) {
+        if (change.kind == PlacementChange::Moved) {
+            moves.push_back(Rearrangement(moves.size() + 1, "move", change.itemId,
+                                          change.before.containerId, change.before.startPos, change.before.endPos,
+                                          change.after.containerId, change.after.startPos, change.after.endPos));
+        } else if (change.kind == PlacementChange::Added) {
+            moves.push_back(Rearrangement(moves.size() + 1, "place", change.itemId, "", Position(), Position(),
+                                          change.after.containerId, change.after.startPos, change.after.endPos));
         }
     }
+    cerr << "Full rearrangement: " << diff.moved << " moved, " << diff.unchanged << " unchanged, "
+         << diff.removed << " removed, " << diff.added << " added" << endl;
     
     return newPlacements;
 }
@@ -478,6 +845,14 @@ using json = nlohmann::json;
 
 using namespace std;
 
+json coordinatesJson(const Position& pos) {
+    return {
+        {"width", pos.width},
+        {"depth", pos.depth},
+        {"height", pos.height}
+    };
+}
+
 int main() {
     ostringstream inputBuffer;
     string line;
@@ -493,7 +868,6 @@ int main() {
     json itemsData = inputJson["items"];
     json containerData = inputJson["containers"];
     json placementData = inputJson["placements"];
-    json priorityItem = inputJson["priorityItem"];
 
     vector<Item> Items;
     vector<Container> Containers;
@@ -525,6 +899,14 @@ int main() {
         Containers.push_back(x);
     }
 
+    // Optional "voxelSize" (input units) turns on the occupancy grid for placement checks
+    if (inputJson.contains("voxelSize") && inputJson["voxelSize"].is_number()) {
+        geom::Coord voxelSize = geom::Fixed::fromInput(inputJson["voxelSize"].get<double>());
+        for (auto& container : Containers) {
+            container.voxelSize = voxelSize;
+        }
+    }
+
     for (int i = 0; i < placementData.size(); i++) {
         Position startCoordinates = {
             placementData[i]["startCoordinates"].contains("width") && !placementData[i]["startCoordinates"]["width"].is_null() ? placementData[i]["startCoordinates"]["width"].get<double>() : 0.0,
@@ -547,18 +929,16 @@ int main() {
         Placements.push_back(x);
     }
 
-    // Example usage of the placeItem function with preferred coordinates
-    Position preferredStart = {
-        priorityItem["startCoordinates"].contains("x") && !priorityItem["startCoordinates"]["x"].is_null() ? priorityItem["startCoordinates"]["x"].get<double>() : 0.0,
-        priorityItem["startCoordinates"].contains("y") && !priorityItem["startCoordinates"]["y"].is_null() ? priorityItem["startCoordinates"]["y"].get<double>() : 0.0,
-        priorityItem["startCoordinates"].contains("z") && !priorityItem["startCoordinates"]["z"].is_null() ? priorityItem["startCoordinates"]["z"].get<double>() : 0.0
-    };
-
-    Position preferredEnd = {
-        priorityItem["endCoordinates"].contains("x") && !priorityItem["endCoordinates"]["x"].is_null() ? priorityItem["endCoordinates"]["x"].get<double>() : 0.0,
-        priorityItem["endCoordinates"].contains("y") && !priorityItem["endCoordinates"]["y"].is_null() ? priorityItem["endCoordinates"]["y"].get<double>() : 0.0,
-        priorityItem["endCoordinates"].contains("z") && !priorityItem["endCoordinates"]["z"].is_null() ? priorityItem["endCoordinates"]["z"].get<double>() : 0.0
-    };
+    // Placement requests: a batch under "priorityItems", or the single legacy "priorityItem".
+    // Each request names an item and optionally a target container and preferred start coordinates.
+    vector<json> placementRequests;
+    if (inputJson.contains("priorityItems") && inputJson["priorityItems"].is_array()) {
+        for (const auto& request : inputJson["priorityItems"]) {
+            placementRequests.push_back(request);
+        }
+    } else if (inputJson.contains("priorityItem") && !inputJson["priorityItem"].is_null()) {
+        placementRequests.push_back(inputJson["priorityItem"]);
+    }
 
     map<string, Item> itemMap;
     for (auto& item : Items) {
@@ -570,54 +950,177 @@ int main() {
         containerMap[container.containerId] = container;
     }
 
-    string itemId = priorityItem["itemId"].get<string>();
-    string containerId = priorityItem["containerId"].get<string>();
+    // Layout as received, for the change report
+    vector<Placement> originalPlacements = Placements;
+
+    // "incremental" (default) keeps the current layout and only moves what the new item needs,
+    // "full" re-packs every item from scratch
+    string rearrangeMode = inputJson.contains("rearrangeMode") && !inputJson["rearrangeMode"].is_null() ? inputJson["rearrangeMode"].get<string>() : "incremental";
+    RearrangeMode mode = rearrangeMode == "full" ? RearrangeMode::Full : RearrangeMode::Incremental;
+
+    // Direct pass: every request that names a container is tried against the shared layout first,
+    // anything left over is stowed by the single rearrangement pass below. A full re-pack discards
+    // the current layout anyway, so there the requests only contribute their item ids.
+    // Repeated requests for one item id are dropped; the first one wins.
+    vector<Rearrangement> moves;
+    vector<string> requestedItemIds;
+    requestedItemIds.reserve(placementRequests.size());
+    unordered_set<string> seenItemIds;
+    for (const auto& request : placementRequests) {
+        string itemId = request.contains("itemId") && !request["itemId"].is_null() ? request["itemId"].get<string>() : "";
+        string containerId = request.contains("containerId") && !request["containerId"].is_null() ? request["containerId"].get<string>() : "";
+        if (!seenItemIds.insert(itemId).second) {
+            cerr << "Duplicate request for item " << itemId << " ignored.\n";
+            continue;
+        }
+        requestedItemIds.push_back(itemId);
+
+        // Without preferred coordinates packItem goes straight to its best-fit search
+        Position preferredStart(-1, -1, -1);
+        if (request.contains("startCoordinates") && request["startCoordinates"].is_object()) {
+            const json& start = request["startCoordinates"];
+            preferredStart = {
+                start.contains("x") && !start["x"].is_null() ? start["x"].get<double>() : 0.0,
+                start.contains("y") && !start["y"].is_null() ? start["y"].get<double>() : 0.0,
+                start.contains("z") && !start["z"].is_null() ? start["z"].get<double>() : 0.0
+            };
+        }
+
+        bool placed = false;
+        if (mode == RearrangeMode::Incremental &&
+            itemMap.find(itemId) != itemMap.end() && containerMap.find(containerId) != containerMap.end()) {
+            // An item that is already stowed is lifted out first, so it neither collides with itself
+            // nor ends up in the layout twice; it goes back untouched if the new spot does not work
+            auto current = find_if(Placements.begin(), Placements.end(),
+                                   [&itemId](const Placement& p) { return p.itemId == itemId; });
+            optional<Placement> previous;
+            if (current != Placements.end()) {
+                previous = *current;
+                Placements.erase(current);
+            }
+
+            Position endPos;
+            placed = packItem(containerMap[containerId], itemMap[itemId], Placements, itemMap, preferredStart, endPos);
+            
+            if (placed) {
+                Placement newPlacement(containerId, itemId, preferredStart, endPos);
+                Placements.push_back(newPlacement);
+                if (previous) {
+                    moves.push_back(Rearrangement(moves.size() + 1, "move", itemId,
+                                                  previous->containerId, previous->startPos, previous->endPos,
+                                                  containerId, preferredStart, endPos));
+                } else {
+                    moves.push_back(Rearrangement(moves.size() + 1, "place", itemId, "", Position(), Position(),
+                                                  containerId, preferredStart, endPos));
+                }
+            } else if (previous) {
+                Placements.push_back(*previous);
+            }
+        }
 
-    bool placed = false;
-    if (itemMap.find(itemId) != itemMap.end() && containerMap.find(containerId) != containerMap.end()) {
-        Position endPos;
-        placed = packItem(containerMap[containerId], itemMap[itemId], Placements, itemMap, preferredStart, endPos);
-        
         if (placed) {
-            Placement newPlacement(containerId, itemId, preferredStart, endPos);
-            Placements.push_back(newPlacement);
+            cerr << "Item " << itemId << " placed successfully.\n";
+        } else {
+            cerr << "Item " << itemId << " placement deferred to rearrangement.\n";
         }
     }
 
-    if (placed) {
-        cout << "Item placed successfully.\n";
-    } else {
-        cout << "Item placement failed.\n";
+    // Optional concurrent evaluation of candidate containers; picks the best fit rather than the first
+    bool parallelPlacement = inputJson.contains("parallelPlacement") && !inputJson["parallelPlacement"].is_null() ? inputJson["parallelPlacement"].get<bool>() : false;
+    unsigned threadCount = inputJson.contains("threads") && !inputJson["threads"].is_null() ? inputJson["threads"].get<unsigned>() : thread::hardware_concurrency();
+    unique_ptr<ThreadPool> pool;
+    if (parallelPlacement) {
+        pool = make_unique<ThreadPool>(threadCount);
     }
 
-    cout << "\nRearranging Items...\n";
-    vector<Placement> newPlacements = rearrangeItems(Items, Containers, Placements);
+    cerr << "\nRearranging Items...\n";
+    vector<Placement> newPlacements = rearrangeItems(Items, Containers, Placements, moves, mode, pool.get());
     
-    cout << "\nFinal Placements after rearrangement:\n";
+    cerr << "\nFinal Placements after rearrangement:\n";
     for (const auto& p : newPlacements) {
-        cout << "Item: " << p.itemId << ", Container: " << p.containerId 
+        cerr << "Item: " << p.itemId << ", Container: " << p.containerId 
              << ", Start: (" << p.startPos.width << ", " << p.startPos.depth << ", " << p.startPos.height << ")"
              << ", End: (" << p.endPos.width << ", " << p.endPos.depth << ", " << p.endPos.height << ")\n";
     }
     
     // Display position changes summary
-    cout << "\nPlacement Changes Summary:" << endl;
-    json result = json::array();
+    json result;
+    result["placements"] = json::array();
     for (const auto& p : newPlacements) {
         json placement;
         placement["itemId"] = p.itemId;
         placement["containerId"] = p.containerId;
-        placement["startCoordinates"] = {
-            {"width", p.startPos.width},
-            {"depth", p.startPos.depth},
-            {"height", p.startPos.height}
-        };
-        placement["endCoordinates"] = {
-            {"width", p.endPos.width},
-            {"depth", p.endPos.depth},
-            {"height", p.endPos.height}
-        };
-        result.push_back(placement);
+        placement["startCoordinates"] = coordinatesJson(p.startPos);
+        placement["endCoordinates"] = coordinatesJson(p.endPos);
+        result["placements"].push_back(placement);
+    }
+
+    // Per-request outcome against the final layout
+    unordered_map<string, const Placement*> finalPlacementByItem;
+    finalPlacementByItem.reserve(newPlacements.size());
+    for (const auto& p : newPlacements) {
+        finalPlacementByItem[p.itemId] = &p;
+    }
+
+    result["results"] = json::array();
+    for (const auto& itemId : requestedItemIds) {
+        json itemResult;
+        itemResult["itemId"] = itemId;
+        auto it = finalPlacementByItem.find(itemId);
+        itemResult["success"] = it != finalPlacementByItem.end();
+        if (it != finalPlacementByItem.end()) {
+            const Placement& p = *it->second;
+            itemResult["containerId"] = p.containerId;
+            itemResult["startCoordinates"] = coordinatesJson(p.startPos);
+            itemResult["endCoordinates"] = coordinatesJson(p.endPos);
+        }
+        result["results"].push_back(itemResult);
+    }
+
+    result["rearrangements"] = json::array();
+    for (const auto& move : moves) {
+        json moveJson;
+        moveJson["step"] = move.step;
+        moveJson["action"] = move.action;
+        moveJson["itemId"] = move.itemId;
+        moveJson["fromContainer"] = move.fromContainer;
+        moveJson["fromStartCoordinates"] = {move.fromStartCoordinates.width, move.fromStartCoordinates.depth, move.fromStartCoordinates.height};
+        moveJson["fromEndCoordinates"] = {move.fromEndCoordinates.width, move.fromEndCoordinates.depth, move.fromEndCoordinates.height};
+        moveJson["toContainer"] = move.toContainer;
+        moveJson["toStartCoordinates"] = {move.toStartCoordinates.width, move.toStartCoordinates.depth, move.toStartCoordinates.height};
+        moveJson["toEndCoordinates"] = {move.toEndCoordinates.width, move.toEndCoordinates.depth, move.toEndCoordinates.height};
+        result["rearrangements"].push_back(moveJson);
+    }
+    
+    PlacementDiff diff = diffPlacements(originalPlacements, newPlacements);
+    result["changes"] = json::array();
+    for (const auto& change : diff.changes) {
+        json changeJson;
+        changeJson["itemId"] = change.itemId;
+        changeJson["change"] = change.kindName();
+        if (change.kind != PlacementChange::Added) {
+            changeJson["fromContainer"] = change.before.containerId;
+            changeJson["fromStartCoordinates"] = coordinatesJson(change.before.startPos);
+            changeJson["fromEndCoordinates"] = coordinatesJson(change.before.endPos);
+        }
+        if (change.kind != PlacementChange::Removed) {
+            changeJson["toContainer"] = change.after.containerId;
+            changeJson["toStartCoordinates"] = coordinatesJson(change.after.startPos);
+            changeJson["toEndCoordinates"] = coordinatesJson(change.after.endPos);
+        }
+        result["changes"].push_back(changeJson);
+    }
+
+    result["changeSummary"] = {
+        {"moved", diff.moved},
+        {"unchanged", diff.unchanged},
+        {"removed", diff.removed},
+        {"added", diff.added}
+    };
+
+    result["containerMoves"] = json::object();
+    for (const auto& [containerId, count] : diff.containerMoves) {
+        result["containerMoves"][containerId] = {{"in", count.in}, {"out", count.out}};
     }
     
     cout << result.dump(4) << endl;
@@ -8,51 +8,322 @@
 #include <algorithm>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
+#include <set>
 #include <ctype.h>
+#include <ctime>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <stdexcept>
+#include <memory>
+#include <string_view>
+#include "geometryKernel.hpp"
 using namespace std;
 
+// Day number used for items without an expiry date ("N/A" or unparsable)
+const int NO_EXPIRY_DAY = std::numeric_limits<int>::max();
+
+// Days since 1970-01-01 for a proleptic Gregorian date (days-from-civil)
+constexpr int daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int>(dayOfEra) - 719468;
+}
+
+// Parses "YYYY-MM-DD" into a day number without allocating; anything else yields NO_EXPIRY_DAY
+int parseCivilDate(const std::string& text) {
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-') return NO_EXPIRY_DAY;
+
+    auto digits = [&text](size_t from, size_t count, int& value) {
+        value = 0;
+        for (size_t i = from; i < from + count; ++i) {
+            if (!isdigit(static_cast<unsigned char>(text[i]))) return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    };
+
+    int year, month, day;
+    if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day)) return NO_EXPIRY_DAY;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return NO_EXPIRY_DAY;
+    return daysFromCivil(year, month, day);
+}
+
+// Today's local date as a day number
+int todayDayNumber() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm local = *std::localtime(&now);
+    return daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+// exp(x) without branches or library calls so batch loops vectorize: x = n*ln2 + r with |r| <= ln2/2,
+// exp(r) from a degree-11 polynomial and 2^n assembled directly in the exponent bits.
+// Relative error stays within a few 1e-15 on [-708, 709]. Outside it the exponent saturates instead of
+// x being clamped, since a clamp to a constant lets the compiler thread the loop on it; valid for |x| < 2^50.
+// Always inlined: a call left in a batch loop stops it from vectorizing.
+[[gnu::always_inline]] inline double fastExp(double x) {
+    const double shifter = 6755399441055744.0; // 1.5 * 2^52, rounds to nearest integer in the low bits
+    double shifted = x * 1.4426950408889634 + shifter;
+    double n = shifted - shifter;
+    double r = x - n * 0.6931471803691238;     // ln2 split into high
+    r -= n * 1.9082149292705877e-10;           // and low parts
+
+    double p = 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // n sits in the low mantissa bits of shifted; reading it there avoids a double to int64 conversion,
+    // which has no SIMD form before AVX-512
+    int64_t shiftedBits, shifterBits;
+    std::memcpy(&shiftedBits, &shifted, sizeof(shiftedBits));
+    std::memcpy(&shifterBits, &shifter, sizeof(shifterBits));
+    int32_t exponent = static_cast<int32_t>(shiftedBits - shifterBits);
+    exponent = exponent < -1022 ? -1022 : exponent;
+    exponent = exponent > 1023 ? 1023 : exponent;
+
+    int64_t bits = static_cast<int64_t>(exponent + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// Item type resolved once at ingest so scoring indexes a table instead of comparing strings
+enum class ItemType : unsigned char { Consumables, Equipment, Payload, Unknown };
+constexpr size_t ITEM_TYPE_COUNT = 4;
+
+ItemType itemTypeFromName(const std::string& name) {
+    if (name == "consumables") return ItemType::Consumables;
+    if (name == "equipment") return ItemType::Equipment;
+    if (name == "payload") return ItemType::Payload;
+    return ItemType::Unknown;
+}
+
+// Everything tunable about the score: factor weights, decay constants and per-type scores
+struct ScoringProfile {
+    double priorityWeight, expiryWeight, usageWeight, zoneWeight, typeWeight, massWeight, volumeWeight;
+    double expiryDecay, massDecay, volumeDecay;
+    double typeScores[ITEM_TYPE_COUNT]; // indexed by ItemType
+};
+
+// The built-in weights. The type term stays switched off (weight 0) so default scores are unchanged;
+// profiles loaded at startup can turn it on.
+inline constexpr ScoringProfile DEFAULT_SCORING_PROFILE = {
+    0.3, 0.2, 0.1, 0.1, 0.0, 0.1, 0.1,
+    0.05, 0.01, 0.01,
+    {0.8, 0.6, 1.0, 0.5},
+};
+
+// Structure-of-arrays view of the score inputs, one entry per item
+struct ScoringColumns {
+    std::vector<int> priority;
+    std::vector<int> expiryDay;
+    std::vector<int> usageLimit;
+    std::vector<unsigned char> inPreferredZone;
+    std::vector<unsigned char> itemType; // ItemType
+    std::vector<double> mass;
+    std::vector<double> volume;
+
+    size_t size() const {
+        return priority.size();
+    }
+
+    void reserve(size_t n) {
+        priority.reserve(n);
+        expiryDay.reserve(n);
+        usageLimit.reserve(n);
+        inPreferredZone.reserve(n);
+        itemType.reserve(n);
+        mass.reserve(n);
+        volume.reserve(n);
+    }
+
+    void push(int itemPriority, int itemExpiryDay, int itemUsageLimit, bool inZone, ItemType type,
+              double itemMass, double itemVolume) {
+        priority.push_back(itemPriority);
+        expiryDay.push_back(itemExpiryDay);
+        usageLimit.push_back(itemUsageLimit);
+        inPreferredZone.push_back(inZone ? 1 : 0);
+        itemType.push_back(static_cast<unsigned char>(type));
+        mass.push_back(itemMass);
+        volume.push_back(itemVolume);
+    }
+};
+
+// A priority score split into the part that moves with the calendar and the part that does not
+struct ScoreTerms {
+    double expiryTerm; // unweighted exp(-0.05 * daysToExpiry)
+    double otherTerms; // weighted sum of every other factor
+};
+
+// A profile's constants folded into the form the batch loop evaluates
+struct ScoringKernel {
+    double base;            // constant part of the mass and zone terms
+    double priorityFactor;
+    double expiryWeight, expiryDecay;
+    double usageWeight;
+    double zoneBonus;       // added when the item sits in its preferred zone
+    double massWeight, massDecay;
+    double volumeWeight, volumeDecay;
+    double typeTerm[ITEM_TYPE_COUNT]; // weighted per-type scores
+    bool hasTypeTerm;
+
+    constexpr explicit ScoringKernel(const ScoringProfile& profile)
+        : base(profile.massWeight + 0.5 * profile.zoneWeight),
+          priorityFactor(profile.priorityWeight / 100.0),
+          expiryWeight(profile.expiryWeight), expiryDecay(profile.expiryDecay),
+          usageWeight(profile.usageWeight),
+          zoneBonus(0.5 * profile.zoneWeight),
+          massWeight(profile.massWeight), massDecay(profile.massDecay),
+          volumeWeight(profile.volumeWeight), volumeDecay(profile.volumeDecay),
+          typeTerm{profile.typeWeight * profile.typeScores[0], profile.typeWeight * profile.typeScores[1],
+                   profile.typeWeight * profile.typeScores[2], profile.typeWeight * profile.typeScores[3]},
+          hasTypeTerm(profile.typeWeight != 0.0) {}
+};
+
+// Kernel for a profile known at compile time; the batch loop sees its members as constants
+template <const ScoringProfile& Profile>
+struct StaticScoringKernel {
+    static constexpr ScoringKernel kernel{Profile};
+};
+
+// Where scoreColumnsWith reads the kernel from: a constexpr object named at compile time, whose members
+// then fold into the loop as constants, or a runtime copy
+template <const ScoringKernel& K>
+struct FixedKernel {
+    static constexpr const ScoringKernel& get() { return K; }
+};
+
+struct RuntimeKernel {
+    const ScoringKernel& kernel;
+    const ScoringKernel& get() const { return kernel; }
+};
+
+// Scores columns[begin, end) with the given kernel. WithType is resolved per batch, not per item.
+// The NO_EXPIRY_DAY select and the integer clamps run first in a pass of their own: left in the scoring
+// loop, the compiler threads it on their constant arms and the branches block vectorization. Both loops
+// vectorize at -O3 (checked with -fopt-info-vec).
+template <bool WithType, typename KernelSource>
+void scoreColumnsWith(KernelSource source, const ScoringColumns& columns, size_t begin, size_t end,
+                      int today, ScoreTerms* __restrict terms, double* __restrict out) {
+    const ScoringKernel& kernel = source.get();
+    const int* __restrict priority = columns.priority.data() + begin;
+    const int* __restrict expiryDay = columns.expiryDay.data() + begin;
+    const int* __restrict usageLimit = columns.usageLimit.data() + begin;
+    const unsigned char* __restrict inZone = columns.inPreferredZone.data() + begin;
+    const unsigned char* __restrict itemType = columns.itemType.data() + begin;
+    const double* __restrict mass = columns.mass.data() + begin;
+    const double* __restrict volume = columns.volume.data() + begin;
+
+    terms += begin;
+    out += begin;
+    const size_t n = end - begin;
+
+    // Clamped days to expiry and usage limits
+    std::vector<int> clamped(2 * n);
+    int* __restrict days = clamped.data();
+    int* __restrict usage = clamped.data() + n;
+    for (size_t i = 0; i < n; ++i) {
+        int d = expiryDay[i] == NO_EXPIRY_DAY ? 999999 : expiryDay[i] - today;
+        days[i] = d < 0 ? 0 : d;
+        usage[i] = usageLimit[i] < 0 ? 0 : usageLimit[i];
+    }
+
+    const double base = kernel.base, priorityFactor = kernel.priorityFactor;
+    const double expiryWeight = kernel.expiryWeight, expiryScale = -kernel.expiryDecay;
+    const double usageWeight = kernel.usageWeight, zoneBonus = kernel.zoneBonus;
+    const double massWeight = kernel.massWeight, massScale = -kernel.massDecay;
+    const double volumeWeight = kernel.volumeWeight, volumeScale = -kernel.volumeDecay;
+    // Per-type terms as selects rather than a table lookup, which would need a gather
+    const double consumablesTerm = kernel.typeTerm[static_cast<size_t>(ItemType::Consumables)];
+    const double equipmentTerm = kernel.typeTerm[static_cast<size_t>(ItemType::Equipment)];
+    const double payloadTerm = kernel.typeTerm[static_cast<size_t>(ItemType::Payload)];
+    const double unknownTerm = kernel.typeTerm[static_cast<size_t>(ItemType::Unknown)];
+
+    for (size_t i = 0; i < n; ++i) {
+        double expiryTerm = fastExp(expiryScale * days[i]);
+        double otherTerms = base +
+            priorityFactor * priority[i] +
+            usageWeight / (1.0 + usage[i]) +
+            zoneBonus * inZone[i] -
+            massWeight * fastExp(massScale * mass[i]) +
+            volumeWeight * fastExp(volumeScale * volume[i]);
+        if constexpr (WithType) {
+            int type = itemType[i]; // compared as int so the mask widens to the double lanes
+            otherTerms += type == static_cast<int>(ItemType::Consumables) ? consumablesTerm
+                        : type == static_cast<int>(ItemType::Equipment) ? equipmentTerm
+                        : type == static_cast<int>(ItemType::Payload) ? payloadTerm
+                        : unknownTerm;
+        }
+        terms[i] = ScoreTerms{expiryTerm, otherTerms};
+        out[i] = std::max(0.0, std::min(1.0, otherTerms + expiryWeight * expiryTerm));
+    }
+}
+
+// Scores with a kernel known at compile time, such as the default profile's
+template <const ScoringKernel& K, bool WithType>
+void scoreColumns(const ScoringColumns& columns, size_t begin, size_t end, int today, ScoreTerms* terms, double* out) {
+    scoreColumnsWith<WithType>(FixedKernel<K>{}, columns, begin, end, today, terms, out);
+}
+
+// Scores with a kernel folded from a profile loaded at runtime
+template <bool WithType>
+void scoreColumns(const ScoringKernel& kernel, const ScoringColumns& columns, size_t begin, size_t end,
+                  int today, ScoreTerms* terms, double* out) {
+    scoreColumnsWith<WithType>(RuntimeKernel{kernel}, columns, begin, end, today, terms, out);
+}
+
 class PriorityCalculator {
 private:
-    const double PRIORITY_WEIGHT = 0.3;
-    const double EXPIRY_WEIGHT = 0.2;
-    const double USAGE_WEIGHT = 0.1;
-    const double ZONE_WEIGHT = 0.1;
-    const double TYPE_WEIGHT = 0.1;
-    const double MASS_WEIGHT = 0.1;
-    const double VOLUME_WEIGHT = 0.1;
-
-    int daysUntilExpiry(const std::string& expiryDate) {
-        // Handle N/A case
-        if (expiryDate == "N/A") return 999999; 
-        
-        std::tm tm = {};
-        std::istringstream ss(expiryDate);
-        ss >> std::get_time(&tm, "%Y-%m-%d");
-        auto expiry = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-        
-        // std::tm current_tm = {};
-        auto now = std::chrono::system_clock::now();
-        auto now_time_t = std::chrono::system_clock::to_time_t(now);
-        auto now_tm = *std::localtime(&now_time_t);
-        std::ostringstream oss;
-        oss << std::setw(4) << std::setfill('0') << (now_tm.tm_year + 1900) << "-"
-            << std::setw(2) << std::setfill('0') << (now_tm.tm_mon + 1) << "-"
-            << std::setw(2) << std::setfill('0') << now_tm.tm_mday;
-        std::string formattedDate = oss.str();
-        std::tm currentDate = {};
-        std::sscanf(formattedDate.c_str(), "%d-%d-%d", &currentDate.tm_year, &currentDate.tm_mon, &currentDate.tm_mday);
-        currentDate.tm_year -= 1900; 
-        currentDate.tm_mon -= 1;  
-        auto current_tm = currentDate;
-        now = std::chrono::system_clock::from_time_t(std::mktime(&current_tm));
-        
-        return std::chrono::duration_cast<std::chrono::hours>(expiry - now).count() / 24;
-    }
+    ScoringProfile profile;
+    ScoringKernel runtimeKernel;   // folded copy of profile, used when it is not the default
+    bool usesDefaultProfile;
+
+    // Reference day all expiry distances are measured from, fixed once per request
+    int referenceDay;
 
 public:
-    double calculatePriorityScore(int itemPriority, const std::string& expiryDate, 
+    PriorityCalculator()
+        : profile(DEFAULT_SCORING_PROFILE), runtimeKernel(DEFAULT_SCORING_PROFILE), usesDefaultProfile(true),
+          referenceDay(todayDayNumber()) {}
+
+    // Switches to a profile loaded at startup; scores computed before the switch are stale
+    void setProfile(const ScoringProfile& newProfile) {
+        profile = newProfile;
+        runtimeKernel = ScoringKernel(newProfile);
+        usesDefaultProfile = false;
+    }
+
+    const ScoringProfile& getProfile() const {
+        return profile;
+    }
+
+    void setReferenceDay(int day) {
+        referenceDay = day;
+    }
+
+    int getReferenceDay() const {
+        return referenceDay;
+    }
+
+    int daysUntilExpiry(int expiryDay) const {
+        if (expiryDay == NO_EXPIRY_DAY) return 999999;
+        return expiryDay - referenceDay;
+    }
 
-/*************  ✨ Codeium Command ⭐  *************/
     /**
      * Calculates a priority score based on the following factors:
      * 1. Item priority (higher is better)
@@ -63,25 +334,28 @@ public:
      * 6. Mass (higher is better)
      * 7. Volume (smaller is better)
      *
-     * The scores are calculated using the following weights and formulas:
+     * The scores are calculated using the following formulas, with the weights, decay constants
+     * and type scores taken from the active ScoringProfile (defaults shown):
      * 1. Item priority score: itemPriority / 100.0
      * 2. Expiry score: exp(-0.05 * daysToExpiry)
      * 3. Usage limit score: 1.0 / (1.0 + usageLimit)
      * 4. Preferred zone score: inPreferredZone ? 1.0 : 0.5
-     * 5. Item type score: type-dependent, with consumables best and unknown worst
+     * 5. Item type score: profile.typeScores[itemType] (weight 0 by default)
      * 6. Mass score: 1.0 - exp(-0.01 * mass)
      * 7. Volume score: exp(-0.01 * volume)
      *
      * The weighted sum of these scores is then returned as the priority score.
+     * expiryDay is a day number from parseCivilDate. calculateScoreTerms returns the sum split into
+     * its expiry and non-expiry parts so a day advance can rescale just the former.
      */
-/******  fe40ce1b-aba8-4044-9d99-650e120a09c3  *******/                                  int usageLimit, bool inPreferredZone, 
-                                  const std::string& itemType, double mass, double volume) {
+    ScoreTerms calculateScoreTerms(int itemPriority, int expiryDay, int usageLimit, bool inPreferredZone,
+                                   ItemType itemType, double mass, double volume) const {
         // 1. Item Priority Score
         double priorityScore = itemPriority / 100.0;
 
         // 2. Expiry Date Score
-        int daysToExpiry = daysUntilExpiry(expiryDate);
-        double expiryScore = std::exp(-0.05 * std::max(0, daysToExpiry)); // Exponential decay
+        int daysToExpiry = daysUntilExpiry(expiryDay);
+        double expiryScore = std::exp(-profile.expiryDecay * std::max(0, daysToExpiry)); // Exponential decay
 
         // 3. Usage Limit Score
         double usageScore = 1.0 / (1.0 +  std::max(0, usageLimit)); // Inverse relationship
@@ -89,30 +363,141 @@ public:
         // 4. Preferred Zone Score
         double zoneScore = inPreferredZone ? 1.0 : 0.5;
 
-        // // 5. Item Type Score
-        // double typeScore;
-        // if (itemType == "consumables") typeScore = 0.8;
-        // else if (itemType == "equipment") typeScore = 0.6;
-        // else if (itemType == "payload") typeScore = 1.0;
-        // else typeScore = 0.5;
+        // 5. Item Type Score
+        double typeScore = profile.typeScores[static_cast<size_t>(itemType)];
 
         // 6. Mass Score (assuming higher mass means higher priority)
-        double massScore = 1.0 - std::exp(-0.01 * mass);
+        double massScore = 1.0 - std::exp(-profile.massDecay * mass);
 
         // 7. Volume Score (assuming smaller volume means higher priority)
-        double volumeScore = std::exp(-0.01 * volume);
+        double volumeScore = std::exp(-profile.volumeDecay * volume);
+
+        // Weighted sum of everything except expiry
+        double otherTerms =
+            profile.priorityWeight * priorityScore +
+            profile.usageWeight * usageScore +
+            profile.zoneWeight * zoneScore +
+            profile.typeWeight * typeScore +
+            profile.massWeight * massScore +
+            profile.volumeWeight * volumeScore;
+
+        return ScoreTerms{expiryScore, otherTerms};
+    }
+
+    double combine(const ScoreTerms& terms) const {
+        return std::max(0.0, std::min(1.0, terms.otherTerms + profile.expiryWeight * terms.expiryTerm));
+    }
+
+    double calculatePriorityScore(int itemPriority, int expiryDay, int usageLimit, bool inPreferredZone,
+                                  ItemType itemType, double mass, double volume) const {
+        return combine(calculateScoreTerms(itemPriority, expiryDay, usageLimit, inPreferredZone, itemType, mass, volume));
+    }
+
+    // Factor an unclamped expiry term grows by when the reference day moves `days` forward
+    double expiryGrowth(int days) const {
+        return std::exp(profile.expiryDecay * days);
+    }
+
+    // Moves an expiry term computed at previousReferenceDay to newReferenceDay. Since
+    // exp(-k * (d - N)) = exp(-k * d) * exp(k * N), an unclamped term is a single multiply by
+    // growth = expiryGrowth(N); only terms entering or leaving the clamp at day 0 are recomputed.
+    double advanceExpiryTerm(double expiryTerm, int expiryDay, int previousReferenceDay, int newReferenceDay,
+                             double growth) const {
+        if (expiryDay == NO_EXPIRY_DAY) return expiryTerm;
+        int daysToExpiry = expiryDay - newReferenceDay;
+        if (daysToExpiry <= 0) return 1.0;
+        if (expiryDay - previousReferenceDay <= 0) return std::exp(-profile.expiryDecay * daysToExpiry);
+        return expiryTerm * growth;
+    }
+
+    // Scores columns[begin, end) into out with the same formula as calculatePriorityScore, folded into
+    // one fused weighted sum. The kernel is picked once here: the default profile runs fully
+    // constant-folded, a loaded profile runs from its folded runtime copy.
+    void calculatePriorityScores(const ScoringColumns& columns, size_t begin, size_t end, ScoreTerms* terms, double* out) const {
+        using DefaultKernel = StaticScoringKernel<DEFAULT_SCORING_PROFILE>;
+        if (usesDefaultProfile) {
+            scoreColumns<DefaultKernel::kernel, DefaultKernel::kernel.hasTypeTerm>(columns, begin, end, referenceDay, terms, out);
+        } else if (runtimeKernel.hasTypeTerm) {
+            scoreColumns<true>(runtimeKernel, columns, begin, end, referenceDay, terms, out);
+        } else {
+            scoreColumns<false>(runtimeKernel, columns, begin, end, referenceDay, terms, out);
+        }
+    }
+
+    // Scores n items at every day offset from their cached terms in one pass: scores[o * n + i] is item
+    // i at offsets[o]. crossingDay[i] is the first day offset >= 0 at which item i scores at least
+    // threshold, or -1 if it never does. Scores only rise with time, so the crossing follows in
+    // closed form from threshold = other + w * exp(-k * (daysToExpiry - t)).
+    void forecastScores(const double* otherTerms, const int* expiryDay, size_t n, const std::vector<int>& offsets,
+                        double threshold, double* scores, int* crossingDay) const {
+        const double weight = profile.expiryWeight;
+        const double decay = profile.expiryDecay;
+        const double scale = -decay;
+
+        // Clamped days to expiry for the current offset, so the scoring loop below has no branches
+        std::vector<int> clampedDays(n);
+        int* __restrict days = clampedDays.data();
+        const double* __restrict other = otherTerms;
+        const int* __restrict expiry = expiryDay;
+
+        for (size_t o = 0; o < offsets.size(); ++o) {
+            const int day = referenceDay + offsets[o];
+            for (size_t i = 0; i < n; ++i) {
+                int d = expiry[i] == NO_EXPIRY_DAY ? 999999 : expiry[i] - day;
+                days[i] = d < 0 ? 0 : d;
+            }
+
+            double* __restrict row = scores + o * n;
+            for (size_t i = 0; i < n; ++i) {
+                double total = other[i] + weight * fastExp(scale * days[i]);
+                row[i] = std::max(0.0, std::min(1.0, total));
+            }
+        }
 
-        // Calculate weighted sum
-        double totalScore = 
-            PRIORITY_WEIGHT * priorityScore +
-            EXPIRY_WEIGHT * expiryScore +
-            USAGE_WEIGHT * usageScore +
-            ZONE_WEIGHT * zoneScore +
-            // TYPE_WEIGHT * typeScore +
-            MASS_WEIGHT * massScore +
-            VOLUME_WEIGHT * volumeScore;
+        for (size_t i = 0; i < n; ++i) {
+            auto scoreAt = [&](int t) {
+                int days = expiryDay[i] == NO_EXPIRY_DAY ? 999999 : expiryDay[i] - referenceDay - t;
+                return std::max(0.0, std::min(1.0, otherTerms[i] + weight * fastExp(-decay * std::max(0, days))));
+            };
 
-        return std::max(0.0, std::min(1.0, totalScore));
+            if (scoreAt(0) >= threshold) {
+                crossingDay[i] = 0;
+                continue;
+            }
+            // The score peaks once the item expires; items that stay below it never cross
+            if (expiryDay[i] == NO_EXPIRY_DAY || decay <= 0.0 || scoreAt(expiryDay[i] - referenceDay) < threshold) {
+                crossingDay[i] = -1;
+                continue;
+            }
+            double needed = (threshold - otherTerms[i]) / weight;
+            // exp(-k * (d - t)) >= needed  <=>  t >= d + ln(needed) / k, nudged past rounding at the edge
+            int daysToExpiry = expiryDay[i] - referenceDay;
+            int t = std::max(0, static_cast<int>(std::ceil(daysToExpiry + std::log(needed) / decay)));
+            while (t > 0 && scoreAt(t - 1) >= threshold) --t;
+            while (t < daysToExpiry && scoreAt(t) < threshold) ++t;
+            crossingDay[i] = scoreAt(t) >= threshold ? t : -1;
+        }
+    }
+
+    // Scores every row, splitting into contiguous chunks across up to `threads` workers
+    void calculatePriorityScores(const ScoringColumns& columns, ScoreTerms* terms, double* out, unsigned threads = 1) const {
+        const size_t minChunk = 16384;
+        size_t n = columns.size();
+        size_t workers = std::max<size_t>(1, std::min<size_t>(threads, n / minChunk));
+        if (workers == 1) {
+            calculatePriorityScores(columns, 0, n, terms, out);
+            return;
+        }
+
+        std::vector<std::thread> pool;
+        size_t chunk = (n + workers - 1) / workers;
+        for (size_t begin = 0; begin < n; begin += chunk) {
+            size_t end = std::min(n, begin + chunk);
+            pool.emplace_back([this, &columns, begin, end, terms, out] {
+                calculatePriorityScores(columns, begin, end, terms, out);
+            });
+        }
+        for (auto& worker : pool) worker.join();
     }
 };
 
@@ -124,91 +509,646 @@ public:
     double mass;
     int priority;
     std::string expiryDate;
+    int expiryDay; // parsed once at ingest, NO_EXPIRY_DAY when there is none
     int usageLimit;
     std::string preferredZone;
     std::string itemType;
+    ItemType typeCode; // itemType resolved at ingest
     std::string currentZone;
+    ScoreTerms scoreTerms; // cached split of priorityScore, rescaled on day advances
     double priorityScore;
     Item(){}
     Item(std::string id, std::string name, int w, int d, int h, double m, 
          int p, std::string exp, int usage, std::string pZone, std::string type)
         : id(id), name(name), width(w), depth(d), height(h), mass(m),
-          priority(p), expiryDate(exp), usageLimit(usage), preferredZone(pZone),
-          currentZone(""), priorityScore(0.0) {}
+          priority(p), expiryDate(exp), expiryDay(parseCivilDate(exp)), usageLimit(usage), preferredZone(pZone),
+          itemType(type), typeCode(itemTypeFromName(type)), currentZone(""), scoreTerms{0.0, 0.0}, priorityScore(0.0) {}
 
     double volume() const {
-        return width * depth * height;
+        return static_cast<double>(geom::InputBox(0, 0, 0, width, depth, height).volume());
     }
 
-    void calculatePriorityScore(PriorityCalculator& calculator) {
-        priorityScore = calculator.calculatePriorityScore(
-            priority, expiryDate, usageLimit, 
-            (currentZone == preferredZone), itemType, mass, volume()
+    void calculatePriorityScore(const PriorityCalculator& calculator) {
+        scoreTerms = calculator.calculateScoreTerms(
+            priority, expiryDay, usageLimit, 
+            (currentZone == preferredZone), typeCode, mass, volume()
         );
+        priorityScore = calculator.combine(scoreTerms);
+    }
+};
+
+// Owns every item the engine knows about. Items live in fixed-size chunks that never move, so a
+// handle, or a pointer from get, stays valid until the item is released. Released handles are
+// reused. The ID index keys on views of the stored IDs rather than copies of them.
+class ItemStore {
+public:
+    using Handle = size_t;
+    static constexpr Handle NONE = static_cast<Handle>(-1);
+
+private:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    std::vector<std::unique_ptr<Item[]>> chunks;
+    std::vector<unsigned char> live;                  // handle -> holds an item
+    std::vector<Handle> freeHandles;
+    std::unordered_map<std::string_view, Handle> handleById;
+
+public:
+    ItemStore() = default;
+    ItemStore(const ItemStore&) = delete;
+    ItemStore& operator=(const ItemStore&) = delete;
+
+    // Stores a new item; its ID must not be stored already
+    Handle insert(const Item& item) {
+        Handle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = live.size();
+            if (handle % CHUNK_SIZE == 0) chunks.emplace_back(new Item[CHUNK_SIZE]);
+            live.push_back(0);
+        }
+        Item& slot = get(handle);
+        slot = item;
+        live[handle] = 1;
+        handleById.emplace(slot.id, handle);
+        return handle;
+    }
+
+    // Overwrites the stored item in place; the ID must stay the same
+    void replace(Handle handle, const Item& item) {
+        handleById.erase(get(handle).id);
+        Item& slot = get(handle);
+        slot = item;
+        handleById.emplace(slot.id, handle);
+    }
+
+    void release(Handle handle) {
+        handleById.erase(get(handle).id);
+        get(handle) = Item();
+        live[handle] = 0;
+        freeHandles.push_back(handle);
+    }
+
+    Handle find(const std::string& id) const {
+        auto it = handleById.find(id);
+        return it == handleById.end() ? NONE : it->second;
+    }
+
+    Item& get(Handle handle) {
+        return chunks[handle / CHUNK_SIZE][handle % CHUNK_SIZE];
+    }
+
+    const Item& get(Handle handle) const {
+        return chunks[handle / CHUNK_SIZE][handle % CHUNK_SIZE];
+    }
+
+    // Every handle handed out so far is below this bound
+    size_t capacity() const {
+        return live.size();
+    }
+
+    size_t size() const {
+        return handleById.size();
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (Handle handle = 0; handle < live.size(); ++handle) {
+            if (live[handle]) fn(handle, get(handle));
+        }
     }
 };
 
+// Indexed 4-ary max-heap on priorityScore over ItemStore handles, so an item can be updated or
+// removed in O(log n) without moving Item copies. Equal scores pop in handle order.
 class ItemPriorityQueue {
+public:
+    using Handle = ItemStore::Handle;
+
 private:
-    struct CompareItem {
-        bool operator()(const Item& a, const Item& b) {
-            return a.priorityScore < b.priorityScore;
+    static constexpr size_t ARITY = 4;
+    static constexpr size_t NOT_IN_HEAP = static_cast<size_t>(-1);
+
+    const ItemStore& store;
+    std::vector<size_t> heapPosition;                 // handle -> index in heap, NOT_IN_HEAP when absent
+    std::vector<Handle> heap;                         // handles in heap order
+
+    bool ranksAbove(Handle a, Handle b) const {
+        double scoreA = store.get(a).priorityScore;
+        double scoreB = store.get(b).priorityScore;
+        if (scoreA != scoreB) {
+            return scoreA > scoreB;
         }
-    };
+        return a < b;
+    }
 
-    std::priority_queue<Item, std::vector<Item>, CompareItem> pq;
+    void place(size_t index, Handle handle) {
+        heap[index] = handle;
+        heapPosition[handle] = index;
+    }
+
+    void siftUp(size_t index) {
+        Handle handle = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / ARITY;
+            if (!ranksAbove(handle, heap[parent])) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, handle);
+    }
+
+    void siftDown(size_t index) {
+        Handle handle = heap[index];
+        size_t n = heap.size();
+        while (true) {
+            size_t first = index * ARITY + 1;
+            if (first >= n) break;
+            size_t best = first;
+            size_t last = std::min(n, first + ARITY);
+            for (size_t child = first + 1; child < last; ++child) {
+                if (ranksAbove(heap[child], heap[best])) best = child;
+            }
+            if (!ranksAbove(heap[best], handle)) break;
+            place(index, heap[best]);
+            index = best;
+        }
+        place(index, handle);
+    }
+
+    // Restores heap order around an entry whose score changed in either direction
+    void repair(size_t index) {
+        if (index > 0 && ranksAbove(heap[index], heap[(index - 1) / ARITY])) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+    }
+
+    void eraseAt(size_t index) {
+        Handle handle = heap[index];
+        Handle last = heap.back();
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(index, last);
+            repair(index);
+        }
+        heapPosition[handle] = NOT_IN_HEAP;
+    }
 
 public:
-    void addItem(const Item& item) {
-        pq.push(item);
+    explicit ItemPriorityQueue(const ItemStore& itemStore) : store(itemStore) {}
+
+    void push(Handle handle) {
+        if (heapPosition.size() <= handle) heapPosition.resize(store.capacity(), NOT_IN_HEAP);
+        heap.push_back(handle);
+        heapPosition[handle] = heap.size() - 1;
+        siftUp(heap.size() - 1);
     }
 
-    Item getTopPriorityItem() {
-        if (pq.empty()) {
+    Handle pop() {
+        if (heap.empty()) {
             throw std::runtime_error("Priority queue is empty");
         }
-        Item top = pq.top();
-        pq.pop();
+        Handle top = heap.front();
+        eraseAt(0);
         return top;
     }
 
     bool isEmpty() const {
-        return pq.empty();
+        return heap.empty();
     }
 
     size_t size() const {
-        return pq.size();
+        return heap.size();
     }
-    
-    std::vector<Item> getAllItemsSorted() {
-        std::vector<Item> sortedItems;
-        std::priority_queue<Item, std::vector<Item>, CompareItem> tempQueue = pq;
-        
-        while (!tempQueue.empty()) {
-            sortedItems.push_back(tempQueue.top());
-            tempQueue.pop();
+
+    bool contains(Handle handle) const {
+        return handle < heapPosition.size() && heapPosition[handle] != NOT_IN_HEAP;
+    }
+
+    // Repairs the position of a queued item after its score changed
+    void update(Handle handle) {
+        repair(heapPosition[handle]);
+    }
+
+    void erase(Handle handle) {
+        eraseAt(heapPosition[handle]);
+    }
+
+    // Restores heap order bottom-up in O(n) after any number of scores changed
+    void rebuild() {
+        if (heap.size() < 2) return;
+        for (size_t index = (heap.size() - 2) / ARITY + 1; index-- > 0;) {
+            siftDown(index);
         }
-        
-        return sortedItems;
+    }
+
+    // The k best handles in rank order. Walks the heap best-first from the root with a frontier of
+    // candidate positions, so it touches O(k * ARITY) entries instead of the whole queue.
+    std::vector<Handle> topK(size_t k) const {
+        std::vector<Handle> result;
+        k = std::min(k, heap.size());
+        if (k == 0) return result;
+        result.reserve(k);
+
+        auto frontierOrder = [this](size_t a, size_t b) {
+            return ranksAbove(heap[b], heap[a]);
+        };
+        std::vector<size_t> frontier;
+        frontier.reserve(k * ARITY + 1);
+        frontier.push_back(0);
+
+        while (!frontier.empty() && result.size() < k) {
+            std::pop_heap(frontier.begin(), frontier.end(), frontierOrder);
+            size_t index = frontier.back();
+            frontier.pop_back();
+            result.push_back(heap[index]);
+
+            size_t first = index * ARITY + 1;
+            size_t last = std::min(heap.size(), first + ARITY);
+            for (size_t child = first; child < last; ++child) {
+                frontier.push_back(child);
+                std::push_heap(frontier.begin(), frontier.end(), frontierOrder);
+            }
+        }
+        return result;
+    }
+
+    // Handles ranked [offset, offset + limit)
+    std::vector<Handle> page(size_t offset, size_t limit) const {
+        if (offset >= heap.size()) return {};
+        std::vector<Handle> ranked = topK(offset + std::min(limit, heap.size() - offset));
+        return std::vector<Handle>(ranked.begin() + offset, ranked.end());
+    }
+
+    // Handles with minScore <= score <= maxScore in rank order. Subtrees whose root scores below
+    // minScore are skipped entirely, since nothing beneath a heap entry can score higher.
+    std::vector<Handle> inScoreRange(double minScore, double maxScore) const {
+        std::vector<Handle> result;
+        if (heap.empty()) return result;
+
+        std::vector<size_t> stack = {0};
+        while (!stack.empty()) {
+            size_t index = stack.back();
+            stack.pop_back();
+            double score = store.get(heap[index]).priorityScore;
+            if (score < minScore) continue;
+            if (score <= maxScore) result.push_back(heap[index]);
+
+            size_t first = index * ARITY + 1;
+            size_t last = std::min(heap.size(), first + ARITY);
+            for (size_t child = first; child < last; ++child) {
+                stack.push_back(child);
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [this](Handle a, Handle b) {
+            return ranksAbove(a, b);
+        });
+        return result;
+    }
+
+    // Every queued handle in rank order
+    std::vector<Handle> sorted() const {
+        std::vector<Handle> order = heap;
+        std::sort(order.begin(), order.end(), [this](Handle a, Handle b) {
+            return ranksAbove(a, b);
+        });
+        return order;
     }
 };
 
-std::unordered_map<std::string, Item> itemsMap;
+// Bucket queue on scores quantized to 16-bit fixed point, over ItemStore handles. Each bucket is an
+// intrusive FIFO list of handles and a three-level bitmap tracks the non-empty buckets, so push,
+// update, erase and pop-max are O(1) word operations. Items within one quantum (1/65535) keep FIFO
+// order, so ranking is deterministic but coarser than ItemPriorityQueue's exact order. Same
+// interface as that queue.
+class ItemBucketQueue {
+public:
+    using Handle = ItemStore::Handle;
+
+private:
+    static constexpr size_t BUCKET_COUNT = size_t(1) << 16;
+    static constexpr size_t NIL = static_cast<size_t>(-1);
+
+    const ItemStore& store;
+    std::vector<uint32_t> bucketOf;                   // handle -> bucket, only meaningful when queued
+    std::vector<size_t> next, prev;                   // handle -> neighbours in its bucket list
+    std::vector<unsigned char> queued;
+    std::vector<size_t> head, tail;                   // bucket -> first / last handle
+    size_t count = 0;
+
+    // Non-empty bucket bitmap: bit b of level0 per bucket, bit w of level1 per non-zero level0
+    // word, bit v of level2 per non-zero level1 word
+    std::vector<uint64_t> level0, level1;
+    uint64_t level2 = 0;
+
+    static uint32_t bucketFor(double score) {
+        score = std::max(0.0, std::min(1.0, score));
+        return static_cast<uint32_t>(score * (BUCKET_COUNT - 1) + 0.5);
+    }
+
+    static size_t highestBit(uint64_t bits) {
+        return 63 - static_cast<size_t>(__builtin_clzll(bits));
+    }
+
+    // Bits 0..bit inclusive
+    static uint64_t maskThrough(size_t bit) {
+        return bit == 63 ? ~uint64_t(0) : (uint64_t(1) << (bit + 1)) - 1;
+    }
+
+    void markNonEmpty(size_t bucket) {
+        size_t word = bucket >> 6;
+        level0[word] |= uint64_t(1) << (bucket & 63);
+        level1[word >> 6] |= uint64_t(1) << (word & 63);
+        level2 |= uint64_t(1) << (word >> 6);
+    }
+
+    void markEmpty(size_t bucket) {
+        size_t word = bucket >> 6;
+        level0[word] &= ~(uint64_t(1) << (bucket & 63));
+        if (level0[word]) return;
+        level1[word >> 6] &= ~(uint64_t(1) << (word & 63));
+        if (level1[word >> 6]) return;
+        level2 &= ~(uint64_t(1) << (word >> 6));
+    }
+
+    size_t highestBucketIn(size_t level1Word) const {
+        size_t word = (level1Word << 6) | highestBit(level1[level1Word]);
+        return (word << 6) | highestBit(level0[word]);
+    }
+
+    // Highest non-empty bucket strictly below limit, or NIL
+    size_t highestBelow(size_t limit) const {
+        if (limit == 0) return NIL;
+        size_t bucket = limit - 1;
+        size_t word = bucket >> 6;
+        uint64_t bits = level0[word] & maskThrough(bucket & 63);
+        if (bits) return (word << 6) | highestBit(bits);
+
+        if (word == 0) return NIL;
+        size_t below = word - 1;
+        bits = level1[below >> 6] & maskThrough(below & 63);
+        if (bits) {
+            size_t found = ((below >> 6) << 6) | highestBit(bits);
+            return (found << 6) | highestBit(level0[found]);
+        }
+
+        if ((below >> 6) == 0) return NIL;
+        bits = level2 & maskThrough((below >> 6) - 1);
+        return bits ? highestBucketIn(highestBit(bits)) : NIL;
+    }
+
+    void link(Handle handle, uint32_t bucket) {
+        bucketOf[handle] = bucket;
+        next[handle] = NIL;
+        prev[handle] = tail[bucket];
+        if (tail[bucket] == NIL) {
+            head[bucket] = handle;
+            markNonEmpty(bucket);
+        } else {
+            next[tail[bucket]] = handle;
+        }
+        tail[bucket] = handle;
+    }
+
+    void unlink(Handle handle) {
+        uint32_t bucket = bucketOf[handle];
+        if (prev[handle] == NIL) head[bucket] = next[handle]; else next[prev[handle]] = next[handle];
+        if (next[handle] == NIL) tail[bucket] = prev[handle]; else prev[next[handle]] = prev[handle];
+        if (head[bucket] == NIL) markEmpty(bucket);
+    }
+
+    // Visits queued handles best-first until visit returns false
+    template <typename Visit>
+    void forEachRanked(Visit visit, size_t fromBucket = BUCKET_COUNT) const {
+        for (size_t bucket = highestBelow(fromBucket); bucket != NIL; bucket = highestBelow(bucket)) {
+            for (Handle handle = head[bucket]; handle != NIL; handle = next[handle]) {
+                if (!visit(handle)) return;
+            }
+        }
+    }
+
+public:
+    explicit ItemBucketQueue(const ItemStore& itemStore)
+        : store(itemStore), head(BUCKET_COUNT, NIL), tail(BUCKET_COUNT, NIL),
+          level0(BUCKET_COUNT / 64, 0), level1(BUCKET_COUNT / 64 / 64, 0) {}
+
+    void push(Handle handle) {
+        if (queued.size() <= handle) {
+            size_t capacity = store.capacity();
+            bucketOf.resize(capacity, 0);
+            next.resize(capacity, NIL);
+            prev.resize(capacity, NIL);
+            queued.resize(capacity, 0);
+        }
+        queued[handle] = 1;
+        link(handle, bucketFor(store.get(handle).priorityScore));
+        ++count;
+    }
+
+    Handle pop() {
+        if (count == 0) {
+            throw std::runtime_error("Priority queue is empty");
+        }
+        Handle top = head[highestBelow(BUCKET_COUNT)];
+        erase(top);
+        return top;
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool contains(Handle handle) const {
+        return handle < queued.size() && queued[handle];
+    }
+
+    // Moves a queued item after its score changed. It keeps its place when its bucket is unchanged
+    // and otherwise joins the back of its new bucket.
+    void update(Handle handle) {
+        uint32_t bucket = bucketFor(store.get(handle).priorityScore);
+        if (bucket != bucketOf[handle]) {
+            unlink(handle);
+            link(handle, bucket);
+        }
+    }
+
+    void erase(Handle handle) {
+        unlink(handle);
+        queued[handle] = 0;
+        --count;
+    }
+
+    // Rebuckets every queued item in one pass after any number of scores changed. Ties in a new
+    // bucket keep their previous rank order.
+    void rebuild() {
+        std::vector<Handle> ranked = topK(count);
+        for (Handle handle : ranked) {
+            unlink(handle);
+        }
+        for (Handle handle : ranked) {
+            link(handle, bucketFor(store.get(handle).priorityScore));
+        }
+    }
+
+    std::vector<Handle> topK(size_t k) const {
+        std::vector<Handle> result;
+        k = std::min(k, count);
+        result.reserve(k);
+        if (k == 0) return result;
+        forEachRanked([&](Handle handle) {
+            result.push_back(handle);
+            return result.size() < k;
+        });
+        return result;
+    }
+
+    // Handles ranked [offset, offset + limit)
+    std::vector<Handle> page(size_t offset, size_t limit) const {
+        if (offset >= count) return {};
+        std::vector<Handle> ranked = topK(offset + std::min(limit, count - offset));
+        return std::vector<Handle>(ranked.begin() + offset, ranked.end());
+    }
+
+    // Handles with minScore <= score <= maxScore in rank order; only buckets in range are visited
+    std::vector<Handle> inScoreRange(double minScore, double maxScore) const {
+        std::vector<Handle> result;
+        if (count == 0 || minScore > maxScore) return result;
+        uint32_t lowest = bucketFor(minScore);
+        forEachRanked([&](Handle handle) {
+            if (bucketOf[handle] < lowest) return false;
+            double score = store.get(handle).priorityScore;
+            if (score >= minScore && score <= maxScore) result.push_back(handle);
+            return true;
+        }, size_t(bucketFor(maxScore)) + 1);
+        return result;
+    }
+
+    // Every queued handle in rank order
+    std::vector<Handle> sorted() const {
+        return topK(count);
+    }
+};
+
+// Queue is ItemPriorityQueue for exact ordering or ItemBucketQueue for O(1) quantized ordering.
+// Items live once, in the store; the queue and the waste indexes hold store handles. Popped items
+// stay in the store, so getItemById still finds them, until removeItem releases them.
+template <typename Queue = ItemPriorityQueue>
 class PriorityCalculationEngine {
 private:
+    using Handle = ItemStore::Handle;
+
     PriorityCalculator calculator;
-    ItemPriorityQueue priorityQueue;
+    ItemStore store;
+    Queue priorityQueue{store};
+    std::unordered_set<Handle> dirtyHandles; // inputs changed since the last score
+
+    // Waste indexes over the queued items: (expiryDay, handle) in expiry order and handles with no
+    // uses left. indexedExpiryDay remembers each handle's key, since dirty edits overwrite the item.
+    std::set<std::pair<int, Handle>> expiryIndex;
+    std::unordered_set<Handle> zeroUsageHandles;
+    std::vector<int> indexedExpiryDay;
+
+    void indexItem(Handle handle) {
+        const Item& item = store.get(handle);
+        if (indexedExpiryDay.size() <= handle) indexedExpiryDay.resize(store.capacity(), NO_EXPIRY_DAY);
+        indexedExpiryDay[handle] = item.expiryDay;
+        if (item.expiryDay != NO_EXPIRY_DAY) expiryIndex.emplace(item.expiryDay, handle);
+        if (item.usageLimit <= 0) zeroUsageHandles.insert(handle);
+    }
+
+    void unindexItem(Handle handle) {
+        if (indexedExpiryDay[handle] != NO_EXPIRY_DAY) {
+            expiryIndex.erase({indexedExpiryDay[handle], handle});
+            indexedExpiryDay[handle] = NO_EXPIRY_DAY;
+        }
+        zeroUsageHandles.erase(handle);
+    }
+
+    // Stores a scored item and queues it, replacing any earlier item with the same ID in place
+    void storeItem(const Item& item) {
+        Handle handle = store.find(item.id);
+        if (handle == ItemStore::NONE) {
+            handle = store.insert(item);
+            priorityQueue.push(handle);
+        } else {
+            bool queued = priorityQueue.contains(handle);
+            if (queued) unindexItem(handle);
+            store.replace(handle, item);
+            if (queued) priorityQueue.update(handle); else priorityQueue.push(handle);
+        }
+        dirtyHandles.erase(handle);
+        indexItem(handle);
+    }
+
+    // Rescores a stored item after one of its inputs changed
+    void rescore(Handle handle) {
+        store.get(handle).calculatePriorityScore(calculator);
+        if (priorityQueue.contains(handle)) priorityQueue.update(handle);
+    }
+
+    std::vector<const Item*> resolve(const std::vector<Handle>& handles) const {
+        std::vector<const Item*> items;
+        items.reserve(handles.size());
+        for (auto handle : handles) {
+            items.push_back(&store.get(handle));
+        }
+        return items;
+    }
 
 public:
+    // Pins "today" for every score computed by this engine
+    void setReferenceDay(int day) {
+        calculator.setReferenceDay(day);
+    }
+
+    // Applies a scoring profile and rescores everything stored under it
+    void setScoringProfile(const ScoringProfile& profile) {
+        calculator.setProfile(profile);
+        store.forEach([this](Handle, Item& item) {
+            item.calculatePriorityScore(calculator);
+        });
+        priorityQueue.rebuild();
+    }
+
     void addItem(const Item& item) {
         Item itemCopy = item;
         itemCopy.calculatePriorityScore(calculator);
-        priorityQueue.addItem(itemCopy);
-        itemsMap[itemCopy.id] = itemCopy;
+        storeItem(itemCopy);
+    }
+
+    // Scores a whole batch column-wise before inserting it
+    void addItems(std::vector<Item>& items, unsigned threads = 1) {
+        ScoringColumns columns;
+        columns.reserve(items.size());
+        for (const auto& item : items) {
+            columns.push(item.priority, item.expiryDay, item.usageLimit, item.currentZone == item.preferredZone,
+                         item.typeCode, item.mass, item.volume());
+        }
+
+        std::vector<ScoreTerms> terms(items.size());
+        std::vector<double> scores(items.size());
+        calculator.calculatePriorityScores(columns, terms.data(), scores.data(), threads);
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].scoreTerms = terms[i];
+            items[i].priorityScore = scores[i];
+            storeItem(items[i]);
+        }
     }
 
     Item getNextPriorityItem() {
-        return priorityQueue.getTopPriorityItem();
+        Handle top = priorityQueue.pop();
+        unindexItem(top);
+        return store.get(top);
     }
 
     void updateItemPriority(Item& item) {
@@ -218,95 +1158,170 @@ public:
     size_t itemCount() const {
         return priorityQueue.size();
     }
+
+    // Flags an item whose inputs were edited through getItemById; advanceClock rescores it in full
+    void markDirty(const std::string& id) {
+        Handle handle = store.find(id);
+        if (handle != ItemStore::NONE) dirtyHandles.insert(handle);
+    }
+
+    // Moves the reference day `days` forward. Clean items only have their cached expiry term
+    // rescaled by one shared factor, dirty items are rescored from scratch, and the queue is
+    // re-heapified once at the end instead of repaired item by item.
+    void advanceClock(int days) {
+        if (days == 0 && dirtyHandles.empty()) return;
+
+        int previousReferenceDay = calculator.getReferenceDay();
+        int newReferenceDay = previousReferenceDay + days;
+        double growth = calculator.expiryGrowth(days);
+        calculator.setReferenceDay(newReferenceDay);
+
+        store.forEach([&](Handle handle, Item& item) {
+            if (dirtyHandles.count(handle)) {
+                item.calculatePriorityScore(calculator);
+                return;
+            }
+            item.scoreTerms.expiryTerm = calculator.advanceExpiryTerm(item.scoreTerms.expiryTerm, item.expiryDay,
+                                                                      previousReferenceDay, newReferenceDay, growth);
+            item.priorityScore = calculator.combine(item.scoreTerms);
+        });
+        priorityQueue.rebuild();
+
+        for (Handle handle : dirtyHandles) {
+            if (!priorityQueue.contains(handle)) continue;
+            unindexItem(handle);
+            indexItem(handle);
+        }
+        dirtyHandles.clear();
+    }
+
+    bool containsItem(const std::string& id) const {
+        Handle handle = store.find(id);
+        return handle != ItemStore::NONE && priorityQueue.contains(handle);
+    }
+
+    // Drops an item from the queue and the store
+    bool removeItem(const std::string& id) {
+        Handle handle = store.find(id);
+        if (handle == ItemStore::NONE) return false;
+        bool queued = priorityQueue.contains(handle);
+        if (queued) {
+            unindexItem(handle);
+            priorityQueue.erase(handle);
+        }
+        dirtyHandles.erase(handle);
+        store.release(handle);
+        return queued;
+    }
+
+    // The queries below hand out pointers into the store; they stay valid until the item is removed
+
+    std::vector<const Item*> getTopItems(size_t k) const {
+        return resolve(priorityQueue.topK(k));
+    }
+
+    std::vector<const Item*> getItemsPage(size_t offset, size_t limit) const {
+        return resolve(priorityQueue.page(offset, limit));
+    }
+
+    std::vector<const Item*> getItemsInScoreRange(double minScore, double maxScore) const {
+        return resolve(priorityQueue.inScoreRange(minScore, maxScore));
+    }
+
+    struct ScoreForecast {
+        std::vector<double> scores; // one per requested offset
+        int crossingDay;            // first day offset scoring >= threshold, -1 if never
+    };
+
+    // Forecasts the given items at every offset (days after the reference day) in one pass over
+    // their cached score terms. Dirty items should be rescored first with advanceClock(0).
+    std::vector<ScoreForecast> forecast(const std::vector<const Item*>& items, const std::vector<int>& offsets,
+                                        double threshold) const {
+        size_t n = items.size();
+        std::vector<double> otherTerms(n);
+        std::vector<int> expiryDay(n);
+        for (size_t i = 0; i < n; ++i) {
+            otherTerms[i] = items[i]->scoreTerms.otherTerms;
+            expiryDay[i] = items[i]->expiryDay;
+        }
+
+        std::vector<double> scores(n * offsets.size());
+        std::vector<int> crossingDay(n);
+        calculator.forecastScores(otherTerms.data(), expiryDay.data(), n, offsets, threshold, scores.data(),
+                                  crossingDay.data());
+
+        std::vector<ScoreForecast> forecasts(n);
+        for (size_t i = 0; i < n; ++i) {
+            forecasts[i].scores.reserve(offsets.size());
+            for (size_t o = 0; o < offsets.size(); ++o) {
+                forecasts[i].scores.push_back(scores[o * n + i]);
+            }
+            forecasts[i].crossingDay = crossingDay[i];
+        }
+        return forecasts;
+    }
     
     std::vector<Item> getAllItemsSortedByPriority() {
-        return priorityQueue.getAllItemsSorted();
+        std::vector<Item> sortedItems;
+        sortedItems.reserve(priorityQueue.size());
+        for (Handle handle : priorityQueue.sorted()) {
+            sortedItems.push_back(store.get(handle));
+        }
+        return sortedItems;
     }
     
     Item* getItemById(const std::string& id) {
-        auto it = itemsMap.find(id);
-        if (it != itemsMap.end()) {
-            return &(it->second);
+        Handle handle = store.find(id);
+        if (handle != ItemStore::NONE) {
+            return &store.get(handle);
         }
         return nullptr;
     }
     
     void updateItemZone(const std::string& id, const std::string& zone) {
-        auto it = itemsMap.find(id);
-        if (it != itemsMap.end()) {
-            it->second.currentZone = zone;
-            it->second.calculatePriorityScore(calculator);
-            
-            // Rebuild priority queue with updated item
-            std::vector<Item> allItems;
-            while (!priorityQueue.isEmpty()) {
-                allItems.push_back(priorityQueue.getTopPriorityItem());
-            }
-            
-            for (const auto& item : allItems) {
-                if (item.id == id) {
-                    priorityQueue.addItem(it->second);
-                } else {
-                    priorityQueue.addItem(item);
-                }
-            }
+        Handle handle = store.find(id);
+        if (handle != ItemStore::NONE) {
+            store.get(handle).currentZone = zone;
+            rescore(handle);
         }
     }
     
     void decrementUsageLimit(const std::string& id) {
-        auto it = itemsMap.find(id);
-        if (it != itemsMap.end() && it->second.usageLimit > 0) {
-            it->second.usageLimit--;
-            it->second.calculatePriorityScore(calculator);
-            
-            // Rebuild priority queue with updated item
-            std::vector<Item> allItems;
-            while (!priorityQueue.isEmpty()) {
-                allItems.push_back(priorityQueue.getTopPriorityItem());
-            }
-            
-            for (const auto& item : allItems) {
-                if (item.id == id) {
-                    priorityQueue.addItem(it->second);
-                } else {
-                    priorityQueue.addItem(item);
-                }
+        Handle handle = store.find(id);
+        if (handle != ItemStore::NONE && store.get(handle).usageLimit > 0) {
+            Item& item = store.get(handle);
+            item.usageLimit--;
+            rescore(handle);
+            if (item.usageLimit == 0 && priorityQueue.contains(handle)) {
+                zeroUsageHandles.insert(handle);
             }
         }
     }
     
-    std::vector<Item> getWasteItems() {
+    // Queued items that are expired as of asOfDay or have no uses left, best score first. Walks
+    // only the expired prefix of the expiry index and the zero-usage set, so the cost follows the
+    // number of waste items rather than the inventory size.
+    std::vector<Item> getWasteItems(int asOfDay) const {
         std::vector<Item> wasteItems;
-        std::vector<Item> allItems = priorityQueue.getAllItemsSorted();
-        
-        // Current date: March 31, 2025
-        std::tm current_tm = {};
-        current_tm.tm_year = 2025 - 1900;
-        current_tm.tm_mon = 3 - 1;
-        current_tm.tm_mday = 31;
-        auto now = std::chrono::system_clock::from_time_t(std::mktime(&current_tm));
-        
-        for (const auto& item : allItems) {
-            // Check if item is expired
-            if (item.expiryDate != "N/A") {
-                std::tm tm = {};
-                std::istringstream ss(item.expiryDate);
-                ss >> std::get_time(&tm, "%Y-%m-%d");
-                auto expiry = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-                
-                if (expiry <= now) {
-                    wasteItems.push_back(item);
-                    continue;
-                }
-            }
-
-            if (item.usageLimit <= 0) {
-                wasteItems.push_back(item);
-            }
+        for (auto it = expiryIndex.begin(); it != expiryIndex.end() && it->first <= asOfDay; ++it) {
+            wasteItems.push_back(store.get(it->second));
+        }
+        for (Handle handle : zeroUsageHandles) {
+            // Already listed when it has also expired
+            int expiryDay = indexedExpiryDay[handle];
+            if (expiryDay != NO_EXPIRY_DAY && expiryDay <= asOfDay) continue;
+            wasteItems.push_back(store.get(handle));
         }
-        
+
+        std::stable_sort(wasteItems.begin(), wasteItems.end(), [](const Item& a, const Item& b) {
+            return a.priorityScore > b.priorityScore;
+        });
         return wasteItems;
     }
+
+    std::vector<Item> getWasteItems() const {
+        return getWasteItems(calculator.getReferenceDay());
+    }
 };
 
 #include "json.hpp"
@@ -316,24 +1331,59 @@ using json = nlohmann::json;
 
 using namespace std;
 
-int main() {
-    PriorityCalculationEngine engine;
-    ostringstream inputBuffer;
-    string line;
+// Reads a profile of the form {"weights": {...}, "decay": {...}, "typeScores": {...}}; anything
+// missing keeps its default value
+ScoringProfile scoringProfileFromJson(const json& config) {
+    ScoringProfile profile = DEFAULT_SCORING_PROFILE;
+    json weights = config.value("weights", json::object());
+    profile.priorityWeight = weights.value("priority", profile.priorityWeight);
+    profile.expiryWeight = weights.value("expiry", profile.expiryWeight);
+    profile.usageWeight = weights.value("usage", profile.usageWeight);
+    profile.zoneWeight = weights.value("zone", profile.zoneWeight);
+    profile.typeWeight = weights.value("type", profile.typeWeight);
+    profile.massWeight = weights.value("mass", profile.massWeight);
+    profile.volumeWeight = weights.value("volume", profile.volumeWeight);
 
-    while(getline(cin, line)) {
-        inputBuffer << line << "\n";
+    json decay = config.value("decay", json::object());
+    profile.expiryDecay = decay.value("expiry", profile.expiryDecay);
+    profile.massDecay = decay.value("mass", profile.massDecay);
+    profile.volumeDecay = decay.value("volume", profile.volumeDecay);
+
+    json typeScores = config.value("typeScores", json::object());
+    const char* typeNames[ITEM_TYPE_COUNT] = {"consumables", "equipment", "payload", "unknown"};
+    for (size_t type = 0; type < ITEM_TYPE_COUNT; ++type) {
+        profile.typeScores[type] = typeScores.value(typeNames[type], profile.typeScores[type]);
     }
+    return profile;
+}
 
-    string inputData = inputBuffer.str();
-    // cout << "Input Data: " << inputData << endl;
+// Scores the request's items with the given queue type and builds the response
+template <typename Queue>
+json runEngine(const json& input) {
+    PriorityCalculationEngine<Queue> engine;
 
-    // string inputJson;
-    // cout << "Got data: "<<inputJson << endl;
-    // getline(cin, inputJson);
+    // Optional "currentDate" (YYYY-MM-DD) replaces the local date as the scoring reference day
+    if (input.contains("currentDate") && input["currentDate"].is_string()) {
+        int referenceDay = parseCivilDate(input["currentDate"].get<string>());
+        if (referenceDay != NO_EXPIRY_DAY) {
+            engine.setReferenceDay(referenceDay);
+        }
+    }
 
-    json input = json::parse(inputData);
+    // Optional named "scoringProfiles", loaded once; "scoringProfile" picks the one to score with
+    if (input.contains("scoringProfile") && input["scoringProfile"].is_string()) {
+        string profileName = input["scoringProfile"];
+        if (input.contains("scoringProfiles") && input["scoringProfiles"].contains(profileName)) {
+            engine.setScoringProfile(scoringProfileFromJson(input["scoringProfiles"][profileName]));
+        } else if (profileName != "default") {
+            cerr << "Unknown scoring profile: " << profileName << endl;
+        }
+    }
 
+    unsigned threads = input.contains("threads") && input["threads"].is_number_unsigned() ? input["threads"].get<unsigned>() : std::thread::hardware_concurrency();
+
+    vector<Item> items;
+    items.reserve(input["items"].size());
     for (const auto& itemData : input["items"]) {
         std::string id = itemData["itemId"];
         std::string name = itemData["name"];
@@ -347,14 +1397,43 @@ int main() {
         string preferredZone = itemData["preferredZone"];
         string itemType = itemData.contains("itemType") ? itemData["itemType"] : "unknown";
 
-        engine.addItem(Item(id, name, width, depth, height, mass, priority, expiryDate, usageLimit, preferredZone, itemType));
+        items.push_back(Item(id, name, width, depth, height, mass, priority, expiryDate, usageLimit, preferredZone, itemType));
+    }
+    engine.addItems(items, threads);
+
+    // Optional "advanceDays" re-scores everything as of that many days after the reference day
+    if (input.contains("advanceDays") && input["advanceDays"].is_number_integer()) {
+        engine.advanceClock(input["advanceDays"].get<int>());
     }
 
     json output;
     output["items"] = json::array();
 
-    vector<Item> sortedItems = engine.getAllItemsSortedByPriority();
-    for (const auto& item : sortedItems) {
+    // Optional "scoreRange": {"min", "max"} filter, or an "offset"/"limit" page of the ranking
+    vector<const Item*> selectedItems;
+    if (input.contains("scoreRange") && input["scoreRange"].is_object()) {
+        double minScore = input["scoreRange"].value("min", 0.0);
+        double maxScore = input["scoreRange"].value("max", 1.0);
+        selectedItems = engine.getItemsInScoreRange(minScore, maxScore);
+    } else {
+        size_t offset = input.contains("offset") && input["offset"].is_number_unsigned() ? input["offset"].get<size_t>() : 0;
+        size_t limit = input.contains("limit") && input["limit"].is_number_unsigned() ? input["limit"].get<size_t>() : engine.itemCount();
+        selectedItems = engine.getItemsPage(offset, limit);
+    }
+
+    // Optional "forecast": {"offsets": [days...], "threshold": score} adds each item's future scores
+    // and the first day it reaches the threshold
+    bool withForecast = input.contains("forecast") && input["forecast"].is_object();
+    vector<int> forecastOffsets;
+    vector<typename PriorityCalculationEngine<Queue>::ScoreForecast> forecasts;
+    if (withForecast) {
+        forecastOffsets = input["forecast"].value("offsets", vector<int>{1, 7, 30});
+        double threshold = input["forecast"].value("threshold", 1.0);
+        forecasts = engine.forecast(selectedItems, forecastOffsets, threshold);
+    }
+
+    for (size_t index = 0; index < selectedItems.size(); ++index) {
+        const Item& item = *selectedItems[index];
         json itemJson;
         itemJson["itemId"] = item.id;
         itemJson["name"] = item.name;
@@ -369,9 +1448,42 @@ int main() {
         itemJson["itemType"] = item.itemType;
         itemJson["priorityScore"] = item.priorityScore;
 
+        if (withForecast) {
+            json forecastJson = json::array();
+            for (size_t o = 0; o < forecastOffsets.size(); ++o) {
+                forecastJson.push_back({{"offset", forecastOffsets[o]}, {"priorityScore", forecasts[index].scores[o]}});
+            }
+            itemJson["forecast"] = forecastJson;
+            itemJson["thresholdDay"] = forecasts[index].crossingDay >= 0 ? json(forecasts[index].crossingDay) : json(nullptr);
+        }
+
         output["items"].push_back(itemJson);
     }
 
+    return output;
+}
+
+int main() {
+    ostringstream inputBuffer;
+    string line;
+
+    while(getline(cin, line)) {
+        inputBuffer << line << "\n";
+    }
+
+    string inputData = inputBuffer.str();
+    // cout << "Input Data: " << inputData << endl;
+
+    // string inputJson;
+    // cout << "Got data: "<<inputJson << endl;
+    // getline(cin, inputJson);
+
+    json input = json::parse(inputData);
+
+    // Optional "queueMode": "bucket" trades exact ordering for O(1) queue operations
+    string queueMode = input.contains("queueMode") && input["queueMode"].is_string() ? input["queueMode"].get<string>() : "heap";
+    json output = queueMode == "bucket" ? runEngine<ItemBucketQueue>(input) : runEngine<ItemPriorityQueue>(input);
+
     cout << output.dump(4) << endl;
 
     return 0;
@@ -9,12 +9,24 @@
 #include <unordered_set>
 #include <cstdlib>
 #include <ctime>
+#include <cstdint>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <optional>
+#include <chrono>
+#include <bit>
+#include <list>
+#include "geometryKernel.hpp"
+#include "threadPool.hpp"
 
 using namespace std;
+
+// Coordinates and dimensions are fixed-point, see geometryKernel.hpp
 struct Position {
-    int x, y, z;  
+    geom::Coord x, y, z;  
     
-    Position(int _x = 0, int _y = 0, int _z = 0) : x(_x), y(_y), z(_z) {}
+    Position(geom::Coord _x = 0, geom::Coord _y = 0, geom::Coord _z = 0) : x(_x), y(_y), z(_z) {}
     
     bool operator==(const Position& other) const {
         return x == other.x && y == other.y && z == other.z;
@@ -34,24 +46,52 @@ namespace std {
     };
 }
 
+// FNV-1a over raw bytes; feeds the container state version
+inline uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+inline uint64_t fnv1a(uint64_t hash, const T& value) {
+    return fnv1a(hash, &value, sizeof(value));
+}
+
+inline uint64_t fnv1a(uint64_t hash, const string& value) {
+    return fnv1a(fnv1a(hash, value.size()), value.data(), value.size());
+}
+
 struct Item {
     string id;
     string name;
     Position position;
-    int width, depth, height;
+    geom::Coord width, depth, height;
+    double priorityScore = 0;   // how soon the item is likely wanted again; weighs re-stow choices
     Item(){
         
     }
-    Item(string _id, string _name, Position _pos, int w, int d, int h)
+    Item(string _id, string _name, Position _pos, geom::Coord w, geom::Coord d, geom::Coord h)
         : id(_id), name(_name), position(_pos), width(w), depth(d), height(h) {}
+
+    geom::FixedBox box() const {
+        return geom::FixedBox(position.x, position.y, position.z, width, depth, height);
+    }
     
-    bool blocksPath(const Position& target) const {
-        
-        return position.y < target.y &&
-               position.x < target.x + width &&
-               position.x + width > target.x &&
-               position.z < target.z + height &&
-               position.z + height > target.z;
+    // Folds every field a plan depends on into hash
+    uint64_t digest(uint64_t hash) const {
+        hash = fnv1a(fnv1a(hash, id), name);
+        hash = fnv1a(fnv1a(fnv1a(hash, position.x), position.y), position.z);
+        hash = fnv1a(fnv1a(fnv1a(hash, width), depth), height);
+        return fnv1a(hash, priorityScore);
+    }
+    
+    // True when this item sits in front of the target on its way out of the open face
+    bool blocksPath(const Item& target) const {
+        return box().blocks(target.box());
     }
 
     friend ostream& operator<<(ostream& os, const Item& item) {
@@ -69,38 +109,183 @@ struct Item {
 struct Container {
     string id;
     string zone;
-    int width, depth, height;
+    geom::Coord width, depth, height;
     vector<Item> items;
 
+    // Blocking DAG over items: blockers[i] must move before items[i] can slide out of the open
+    // face, and blocked[i] lists the items that items[i] stands in front of. Edges always point to
+    // a larger y, so the graph is acyclic. Both lists are kept in ascending index order. Kept current
+    // by addItems, addItem and removeItem, so items must not be moved through findItem.
+    vector<vector<size_t>> blockers;
+    vector<vector<size_t>> blocked;
+    unordered_map<string, size_t> indexById;
+
+    // Optional voxel bitmap; answers isOccupied and lets laneFreeDepth skip the item scan for empty lanes
+    optional<geom::FixedOccupancyGrid> occupancy;
+
+    // State version: a digest of the dimensions and of every addItem and removeItem in order, so any
+    // placement change gives a new version and the same layout rebuilt in another process agrees
+    uint64_t version = 0;
+
     Container(){
 
     }
     
-    Container(string _id, string _zone, int w, int d, int h)
-        : id(_id), zone(_zone), width(w), depth(d), height(h) {}
+    Container(string _id, string _zone, geom::Coord w, geom::Coord d, geom::Coord h)
+        : id(_id), zone(_zone), width(w), depth(d), height(h) {
+        version = fnv1a(fnv1a(fnv1a(fnv1a(0xCBF29CE484222325ULL, id), w), d), h);
+    }
+
+    // Stores the item and updates the index, version and grid, but not the DAG; returns its index
+    size_t append(const Item& item) {
+        size_t index = items.size();
+        items.push_back(item);
+        indexById[item.id] = index;
+        version = item.digest(fnv1a(version, '+'));
+        if (occupancy) occupancy->add(item.box());
+        return index;
+    }
     
+    // Bulk load: appends every item, then rebuilds the blocking DAG in one sweep
+    void addItems(const vector<Item>& batch) {
+        for (const auto& item : batch) append(item);
+        rebuildBlockingGraph();
+    }
+
+    // Links the new item against every other one, O(n); prefer addItems when loading many
     void addItem(const Item& item) {
-        items.push_back(item);
+        size_t index = append(item);
+        blockers.emplace_back();
+        blocked.emplace_back();
+
+        geom::FixedBox box = item.box();
+        for (size_t other = 0; other < index; ++other) {
+            geom::FixedBox otherBox = items[other].box();
+            if (otherBox.blocks(box)) {
+                blockers[index].push_back(other);
+                blocked[other].push_back(index);
+            } else if (box.blocks(otherBox)) {
+                blockers[other].push_back(index);
+                blocked[index].push_back(other);
+            }
+        }
+    }
+    
+    // Rebuilds the blocking DAG from scratch. Items are swept from the open face inwards and filed in
+    // a coarse grid over the (x, z) face, so each one is only tested against the nearer items sharing
+    // a face cell with it. That is O(n + edges) for items small against the face, where linking items
+    // one by one costs O(n^2) for every load.
+    void rebuildBlockingGraph() {
+        const size_t n = items.size();
+        blockers.assign(n, {});
+        blocked.assign(n, {});
+        if (n == 0) return;
+
+        vector<geom::FixedBox> boxes(n);
+        for (size_t i = 0; i < n; ++i) boxes[i] = items[i].box();
+
+        const geom::Coord cellsPerAxis = max<geom::Coord>(1, static_cast<geom::Coord>(sqrt(static_cast<double>(n))));
+        const geom::Coord cellWidth = max<geom::Coord>(1, (width + cellsPerAxis - 1) / cellsPerAxis);
+        const geom::Coord cellHeight = max<geom::Coord>(1, (height + cellsPerAxis - 1) / cellsPerAxis);
+        auto cellRange = [cellsPerAxis](geom::Coord lo, geom::Coord hi, geom::Coord size) {
+            geom::Coord first = min(cellsPerAxis - 1, max<geom::Coord>(0, lo / size));
+            geom::Coord last = min(cellsPerAxis - 1, max<geom::Coord>(0, (hi - 1) / size));
+            return make_pair(first, max(first, last));
+        };
+        vector<vector<size_t>> cells(size_t(cellsPerAxis) * cellsPerAxis);
+
+        vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) order[i] = i;
+        stable_sort(order.begin(), order.end(), [&boxes](size_t a, size_t b) { return boxes[a].y < boxes[b].y; });
+
+        // An item spanning several cells is met once per cell; seenBy keeps it to one test per query
+        vector<size_t> seenBy(n, static_cast<size_t>(-1));
+        for (size_t begin = 0; begin < n;) {
+            size_t end = begin;
+            while (end < n && boxes[order[end]].y == boxes[order[begin]].y) ++end;
+
+            // Query the whole group of equal y before filing any of it, since blocking needs a smaller y
+            for (size_t k = begin; k < end; ++k) {
+                size_t i = order[k];
+                auto [x0, x1] = cellRange(boxes[i].x, boxes[i].maxX(), cellWidth);
+                auto [z0, z1] = cellRange(boxes[i].z, boxes[i].maxZ(), cellHeight);
+                for (geom::Coord cz = z0; cz <= z1; ++cz) {
+                    for (geom::Coord cx = x0; cx <= x1; ++cx) {
+                        for (size_t j : cells[size_t(cz) * cellsPerAxis + cx]) {
+                            if (seenBy[j] == i) continue;
+                            seenBy[j] = i;
+                            if (boxes[j].blocks(boxes[i])) {
+                                blockers[i].push_back(j);
+                                blocked[j].push_back(i);
+                            }
+                        }
+                    }
+                }
+            }
+            for (size_t k = begin; k < end; ++k) {
+                size_t i = order[k];
+                auto [x0, x1] = cellRange(boxes[i].x, boxes[i].maxX(), cellWidth);
+                auto [z0, z1] = cellRange(boxes[i].z, boxes[i].maxZ(), cellHeight);
+                for (geom::Coord cz = z0; cz <= z1; ++cz) {
+                    for (geom::Coord cx = x0; cx <= x1; ++cx) cells[size_t(cz) * cellsPerAxis + cx].push_back(i);
+                }
+            }
+            begin = end;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            sort(blockers[i].begin(), blockers[i].end());
+            sort(blocked[i].begin(), blocked[i].end());
+        }
     }
     
+    // Unlinks the item from the DAG and fills its slot with the last item
     bool removeItem(const string& itemId) {
-        auto it = find_if(items.begin(), items.end(), 
-                         [&itemId](const Item& item) { return item.id == itemId; });
-        if (it != items.end()) {
-            items.erase(it);
-            return true;
+        auto it = indexById.find(itemId);
+        if (it == indexById.end()) return false;
+        size_t index = it->second;
+        indexById.erase(it);
+        version = fnv1a(fnv1a(version, '-'), itemId);
+        if (occupancy) occupancy->remove(items[index].box());
+
+        auto replaceIn = [](vector<size_t>& list, size_t from, size_t to) {
+            auto found = find(list.begin(), list.end(), from);
+            if (to == static_cast<size_t>(-1)) {
+                *found = list.back();
+                list.pop_back();
+            } else {
+                *found = to;
+            }
+        };
+        for (size_t other : blockers[index]) replaceIn(blocked[other], index, static_cast<size_t>(-1));
+        for (size_t other : blocked[index]) replaceIn(blockers[other], index, static_cast<size_t>(-1));
+
+        size_t last = items.size() - 1;
+        if (index != last) {
+            items[index] = std::move(items[last]);
+            blockers[index] = std::move(blockers[last]);
+            blocked[index] = std::move(blocked[last]);
+            for (size_t other : blockers[index]) replaceIn(blocked[other], last, index);
+            for (size_t other : blocked[index]) replaceIn(blockers[other], last, index);
+            indexById[items[index].id] = index;
         }
-        return false;
+        items.pop_back();
+        blockers.pop_back();
+        blocked.pop_back();
+        return true;
     }
     
     Item* findItem(const string& itemId) {
-        auto it = find_if(items.begin(), items.end(), 
-                         [&itemId](const Item& item) { return item.id == itemId; });
-        if (it != items.end()) {
-            return &(*it);
+        auto it = indexById.find(itemId);
+        if (it != indexById.end()) {
+            return &items[it->second];
         }
         return nullptr;
     }
+
+    size_t indexOf(const Item& item) const {
+        return indexById.at(item.id);
+    }
     
     bool isWithinBounds(const Position& pos) const {
         return pos.x >= 0 && pos.x < width &&
@@ -108,314 +293,1101 @@ struct Container {
                pos.z >= 0 && pos.z < height;
     }
     
+    // Builds the occupancy grid with voxels of voxelSize along each axis; kept current from then on
+    void enableOccupancyGrid(geom::Coord voxelSize) {
+        occupancy.emplace(width, depth, height, voxelSize);
+        for (const auto& item : items) {
+            occupancy->add(item.box());
+        }
+    }
+    
+    // The grid settles points in empty or fully covered voxels; the rest fall back to the item scan
     bool isOccupied(const Position& pos) const {
+        if (occupancy) {
+            auto state = occupancy->pointState(pos.x, pos.y, pos.z);
+            if (state != geom::FixedOccupancyGrid::Occupancy::Partial) {
+                return state == geom::FixedOccupancyGrid::Occupancy::Occupied;
+            }
+        }
         for (const auto& item : items) {
-            if (pos.x >= item.position.x && pos.x < item.position.x + item.width &&
-                pos.y >= item.position.y && pos.y < item.position.y + item.depth &&
-                pos.z >= item.position.z && pos.z < item.position.z + item.height) {
+            if (item.box().containsPoint(pos.x, pos.y, pos.z)) {
                 return true;
             }
         }
         return false;
     }
+
+    // Front face of the nearest item standing in a lane that runs the full depth from the open face,
+    // or the container depth when nothing does. The grid settles empty lanes without the item scan.
+    geom::Coord laneFreeDepth(const geom::FixedBox& lane) const {
+        if (occupancy && occupancy->regionState(lane) == geom::FixedOccupancyGrid::Occupancy::Empty) {
+            return depth;
+        }
+        geom::Coord freeDepth = depth;
+        for (const auto& item : items) {
+            geom::FixedBox box = item.box();
+            if (box.overlapsFace(lane)) freeDepth = min(freeDepth, box.y);
+        }
+        return freeDepth;
+    }
 };
 
 struct RetrievalStep {
     int stepNumber;
-    string action;  //remove, setAside, retrieve, placeBack
+    string action;  //remove, setAside, relocate, retrieve, placeBack
     string itemId;
     string itemName;
+    optional<Position> destination;  // relocate, or placeBack when re-stowed: the item's new corner
     
-    RetrievalStep(int step, string act, string id, string name)
-        : stepNumber(step), action(act), itemId(id), itemName(name) {}
+    RetrievalStep(int step, string act, string id, string name, optional<Position> dest = nullopt)
+        : stepNumber(step), action(act), itemId(id), itemName(name), destination(dest) {}
+};
+
+// Binary min-heap over indices 0..n-1 with a position index, so contains() is O(1) and a key can be
+// lowered in place instead of erasing and re-pushing. Equal keys pop in index order.
+template <typename Key>
+class IndexedMinHeap {
+private:
+    static constexpr size_t ABSENT = static_cast<size_t>(-1);
+
+    vector<size_t> heap;
+    vector<size_t> position;
+    vector<Key> keys;
+
+    bool before(size_t a, size_t b) const {
+        if (keys[a] < keys[b]) return true;
+        if (keys[b] < keys[a]) return false;
+        return a < b;
+    }
+
+    void place(size_t slot, size_t index) {
+        heap[slot] = index;
+        position[index] = slot;
+    }
+
+    void siftUp(size_t slot) {
+        size_t index = heap[slot];
+        while (slot > 0) {
+            size_t parent = (slot - 1) / 2;
+            if (!before(index, heap[parent])) break;
+            place(slot, heap[parent]);
+            slot = parent;
+        }
+        place(slot, index);
+    }
+
+    void siftDown(size_t slot) {
+        size_t index = heap[slot];
+        while (true) {
+            size_t child = slot * 2 + 1;
+            if (child >= heap.size()) break;
+            if (child + 1 < heap.size() && before(heap[child + 1], heap[child])) ++child;
+            if (!before(heap[child], index)) break;
+            place(slot, heap[child]);
+            slot = child;
+        }
+        place(slot, index);
+    }
+
+public:
+    explicit IndexedMinHeap(size_t n) : position(n, ABSENT), keys(n) {
+        heap.reserve(n);
+    }
+
+    bool empty() const { return heap.empty(); }
+    bool contains(size_t index) const { return position[index] != ABSENT; }
+    const Key& key(size_t index) const { return keys[index]; }
+    const Key& topKey() const { return keys[heap.front()]; }
+
+    void push(size_t index, const Key& key) {
+        keys[index] = key;
+        heap.push_back(index);
+        position[index] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    }
+
+    void decreaseKey(size_t index, const Key& key) {
+        keys[index] = key;
+        siftUp(position[index]);
+    }
+
+    size_t pop() {
+        size_t top = heap.front();
+        size_t last = heap.back();
+        heap.pop_back();
+        position[top] = ABSENT;
+        if (!heap.empty()) {
+            place(0, last);
+            siftDown(0);
+        }
+        return top;
+    }
+};
+
+// Ant colony parameters for the "aco" planner
+struct AcoSettings {
+    int numAnts = 10;
+    int maxIterations = 100;
+    int patience = 10;                // stop after this many iterations without a better path
+    double evaporationRate = 0.5;
+    double alpha = 1.0;               // pheromone
+    double beta = 2.0;                // proximity
+    uint64_t seed = 0x5EEDULL;
+    unsigned threads = 0;             // 0 = hardware concurrency
+    size_t parallelThreshold = 64;    // blockers needed before ants run on several threads
+};
+
+// Limits for the "exact" planner; past either one it falls back to the A* plan
+struct ExactSettings {
+    size_t maxBlockers = 20;          // blockers the search may branch over, at most 32
+    size_t maxSlots = 24;             // free slots offered for relocation, at most 32
+    double timeBudgetMs = 50.0;
+};
+
+// Re-stow on placeBack: set-aside blockers may go back to other slots than their own
+struct RestowSettings {
+    bool enabled = false;
+    size_t maxSlots = 24;             // free slots offered besides the blockers' own spots
+};
+
+// LRU cache of retrieval plans keyed by (container id, container version, item id, algorithm and
+// its settings). Versions are content digests, so entries stay valid across planner processes when
+// the cache is persisted between them (see loadPlanCache / savePlanCache).
+class PlanCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        double hitRate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    using Entry = pair<string, vector<RetrievalStep>>;
+
+    explicit PlanCache(size_t _capacity = 256) : capacity(_capacity) {}
+
+    static string key(const string& containerId, uint64_t version, const string& itemId,
+                      const string& algorithm, uint64_t settings) {
+        return containerId + '\x1f' + to_string(version) + '\x1f' + itemId + '\x1f' + algorithm + '\x1f' + to_string(settings);
+    }
+
+    // The cached plan, refreshed as most recently used, or nullptr on a miss
+    const vector<RetrievalStep>* get(const string& key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            ++counters.misses;
+            return nullptr;
+        }
+        ++counters.hits;
+        if (it->second != entries.begin()) {
+            entries.splice(entries.begin(), entries, it->second);
+            modified = true;
+        }
+        return &it->second->second;
+    }
+
+    void put(const string& key, const vector<RetrievalStep>& plan) {
+        if (capacity == 0) return;
+        modified = true;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second->second = plan;
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+        if (entries.size() == capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, plan);
+        index[key] = entries.begin();
+    }
+
+    void resize(size_t newCapacity) {
+        capacity = newCapacity;
+        while (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+            modified = true;
+        }
+    }
+
+    // Most recently used first
+    const list<Entry>& contents() const {
+        return entries;
+    }
+
+    // True when the contents changed since the last markSaved
+    bool dirty() const {
+        return modified;
+    }
+
+    void markSaved() {
+        modified = false;
+    }
+
+    const Stats& stats() const {
+        return counters;
+    }
+
+private:
+    size_t capacity;
+    list<Entry> entries;
+    unordered_map<string, list<Entry>::iterator> index;
+    Stats counters;
+    bool modified = false;
 };
 
 class RetrievalPathPlanner {
 private:
     unordered_map<string, Container> containers;
+    AcoSettings acoSettings;
+    ExactSettings exactSettings;
+    RestowSettings restowSettings;
+    PlanCache planCache;
+
+    // Digest of every setting a plan can depend on; part of the plan cache key
+    uint64_t settingsDigest() const {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        hash = fnv1a(fnv1a(fnv1a(fnv1a(hash, acoSettings.numAnts), acoSettings.maxIterations), acoSettings.patience), acoSettings.evaporationRate);
+        hash = fnv1a(fnv1a(fnv1a(fnv1a(hash, acoSettings.alpha), acoSettings.beta), acoSettings.seed), acoSettings.threads);
+        hash = fnv1a(hash, acoSettings.parallelThreshold);
+        hash = fnv1a(fnv1a(fnv1a(hash, exactSettings.maxBlockers), exactSettings.maxSlots), exactSettings.timeBudgetMs);
+        return fnv1a(fnv1a(hash, restowSettings.enabled), restowSettings.maxSlots);
+    }
 
-    vector<Item> findBlockingItems(const Container& container, const Item& targetItem) {
+    // Indices of every target and every item that has to move before some target can come out, in a
+    // valid removal order: the targets and their ancestors in the container's blocking DAG, walked
+    // topologically so each item comes after its own blockers. Among items free to move, the one
+    // nearest a target goes first. Costs O(b log b) in the items involved, independent of container
+    // size, and an item shared by several targets' blockers appears once.
+    vector<size_t> jointRemovalOrder(const Container& container, const vector<size_t>& targets) {
         struct Node {
-            Item item;
             int gCost;
             int hCost;
             int fCost() const { return gCost + hCost; }
+            bool operator<(const Node& other) const {
+                return fCost() < other.fCost() || (fCost() == other.fCost() && hCost < other.hCost);
+            }
         };
     
         auto heuristic = [](const Position& a, const Position& b) {
             return abs(a.x - b.x) + abs(a.y - b.y) + abs(a.z - b.z);
         };
+        auto nearestTarget = [&](size_t index) {
+            int best = numeric_limits<int>::max();
+            for (size_t target : targets) {
+                best = min(best, heuristic(container.items[index].position, container.items[target].position));
+            }
+            return best;
+        };
     
-        vector<Node> openList;
-        unordered_map<string, Node> closedList;
-    
-        for (const auto& item : container.items) {
-            if (item.id == targetItem.id) continue;
-            if (item.blocksPath(targetItem.position)) {
-                int hCost = heuristic(item.position, targetItem.position);
-                openList.push_back({item, 0, hCost});
+        // Collect targets and ancestors with a bitset as the visited set
+        const size_t n = container.items.size();
+        vector<uint64_t> visited((n + 63) / 64, 0);
+        auto isVisited = [&visited](size_t index) { return (visited[index >> 6] >> (index & 63)) & 1; };
+        auto visit = [&visited](size_t index) { visited[index >> 6] |= uint64_t(1) << (index & 63); };
+
+        vector<size_t> involved;
+        vector<size_t> stack(targets.begin(), targets.end());
+        while (!stack.empty()) {
+            size_t index = stack.back();
+            stack.pop_back();
+            if (isVisited(index)) continue;
+            visit(index);
+            involved.push_back(index);
+            for (size_t blocker : container.blockers[index]) {
+                if (!isVisited(blocker)) stack.push_back(blocker);
+            }
+        }
+
+        // Kahn's algorithm over the involved subgraph; gCost is the item's removal depth
+        unordered_map<size_t, int> pendingBlockers;
+        IndexedMinHeap<Node> openList(n);
+        for (size_t index : involved) {
+            int pending = static_cast<int>(container.blockers[index].size());
+            if (pending == 0) {
+                openList.push(index, {0, nearestTarget(index)});
+            } else {
+                pendingBlockers[index] = pending;
             }
         }
     
-        vector<Item> blockingItems;
-    
+        vector<size_t> order;
+        order.reserve(involved.size());
         while (!openList.empty()) {
-            sort(openList.begin(), openList.end(), [](const Node& a, const Node& b) {
-                return a.fCost() < b.fCost() || (a.fCost() == b.fCost() && a.hCost < b.hCost);
-            });
-    
-            Node currentNode = openList.front();
-            openList.erase(openList.begin());
-            blockingItems.push_back(currentNode.item);
-            closedList[currentNode.item.id] = currentNode;
+            Node currentNode = openList.topKey();
+            size_t current = openList.pop();
+            order.push_back(current);
     
-            if (currentNode.item.position.y >= targetItem.position.y) break;
-    
-            for (const auto& neighbor : container.items) {
-                if (neighbor.id == targetItem.id || closedList.count(neighbor.id)) continue;
-                if (neighbor.blocksPath(targetItem.position)) {
-                    int gCost = currentNode.gCost + 1;
-                    int hCost = heuristic(neighbor.position, targetItem.position);
-    
-                    auto it = find_if(openList.begin(), openList.end(), [&neighbor](const Node& node) {
-                        return node.item.id == neighbor.id;
-                    });
-    
-                    if (it == openList.end() || gCost + hCost < it->fCost()) {
-                        if (it != openList.end()) openList.erase(it);
-                        openList.push_back({neighbor, gCost, hCost});
-                    }
+            for (size_t next : container.blocked[current]) {
+                if (!isVisited(next)) continue;
+                if (--pendingBlockers[next] == 0) {
+                    openList.push(next, {currentNode.gCost + 1, nearestTarget(next)});
                 }
             }
         }
     
+        return order;
+    }
+
+    // The items that have to move before the target can come out, in removal order
+    vector<size_t> blockersOf(const Container& container, size_t target) {
+        vector<size_t> blockingItems;
+        for (size_t index : jointRemovalOrder(container, {target})) {
+            if (index != target) blockingItems.push_back(index);
+        }
         return blockingItems;
     }
-    
-    vector<RetrievalStep> planRetrievalWithDijkstra(const string& containerId, const string& itemId) {
+
+    bool isDirectlyAccessible(const Container& container, const Item& item) {
+        return item.position.y == 0 || container.blockers[container.indexOf(item)].empty();
+    }
+
+    // One blocker out of the way: set aside and placed back, at returnTo when re-stowed, or
+    // relocated for good to `destination`
+    struct Move {
+        size_t index;
+        optional<Position> destination;
+        optional<Position> returnTo = nullopt;
+    };
+
+    static vector<Move> setAsideAll(const vector<size_t>& blockingItems) {
+        vector<Move> moves;
+        moves.reserve(blockingItems.size());
+        for (size_t index : blockingItems) moves.push_back({index, nullopt});
+        return moves;
+    }
+
+    // Removes and sets aside or relocates each blocker in turn, retrieves the target, then places
+    // the set-aside blockers back in reverse order, or deepest slot first once re-stowed
+    static vector<RetrievalStep> emitSteps(const Container& container, size_t target, const vector<Move>& moves) {
         vector<RetrievalStep> steps;
-        
-        if (containers.find(containerId) == containers.end()) {
-            return steps; 
+        int stepCount = 1;
+        for (const Move& move : moves) {
+            const Item& item = container.items[move.index];
+            steps.push_back(RetrievalStep(stepCount++, "remove", item.id, item.name));
+            if (move.destination) {
+                steps.push_back(RetrievalStep(stepCount++, "relocate", item.id, item.name, move.destination));
+            } else {
+                steps.push_back(RetrievalStep(stepCount++, "setAside", item.id, item.name));
+            }
         }
-        
-        Container& container = containers[containerId];
-        
-        Item* targetItem = container.findItem(itemId);
-        if (!targetItem) {
-            return steps; 
+
+        const Item& targetItem = container.items[target];
+        steps.push_back(RetrievalStep(stepCount++, "retrieve", targetItem.id, targetItem.name));
+
+        vector<const Move*> placeBack;
+        bool restowed = false;
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+            if (it->destination) continue;
+            placeBack.push_back(&*it);
+            restowed = restowed || it->returnTo;
         }
-        
-        if (targetItem->position.y == 0) {
-            steps.push_back(RetrievalStep(1, "retrieve", targetItem->id, targetItem->name));
-            return steps;
+        if (restowed) {
+            auto depth = [&](const Move* move) { return move->returnTo ? move->returnTo->y : container.items[move->index].position.y; };
+            stable_sort(placeBack.begin(), placeBack.end(), [&](const Move* a, const Move* b) { return depth(a) > depth(b); });
         }
-        
-        vector<Item> blockingItems = findBlockingItems(container, *targetItem);
-        
-        if (blockingItems.empty()) {
-            steps.push_back(RetrievalStep(1, "retrieve", targetItem->id, targetItem->name));
-            return steps;
+        for (const Move* move : placeBack) {
+            const Item& item = container.items[move->index];
+            steps.push_back(RetrievalStep(stepCount++, "placeBack", item.id, item.name, move->returnTo));
         }
-        
-        int stepCount = 1;
-        
-        for (const auto& item : blockingItems) {
-            steps.push_back(RetrievalStep(stepCount++, "remove", item.id, item.name));
-            steps.push_back(RetrievalStep(stepCount++, "setAside", item.id, item.name));
+        return steps;
+    }
+
+    // The core every algorithm shares: container and target lookup, the direct-access shortcut and
+    // the blocker search, with Policy::arrange turning the blockers into moves
+    template <typename Policy>
+    vector<RetrievalStep> planWith(const string& containerId, const string& itemId) {
+        auto containerIt = containers.find(containerId);
+        if (containerIt == containers.end()) {
+            return {};
         }
-        
-        steps.push_back(RetrievalStep(stepCount++, "retrieve", targetItem->id, targetItem->name));
-        
-        for (auto it = blockingItems.rbegin(); it != blockingItems.rend(); ++it) {
-            steps.push_back(RetrievalStep(stepCount++, "placeBack", it->id, it->name));
+        const Container& container = containerIt->second;
+
+        auto targetIt = container.indexById.find(itemId);
+        if (targetIt == container.indexById.end()) {
+            return {};
         }
-        
-        return steps;
+        size_t target = targetIt->second;
+
+        vector<Move> moves;
+        if (!isDirectlyAccessible(container, container.items[target])) {
+            moves = Policy::arrange(*this, container, target, blockersOf(container, target));
+            if (restowSettings.enabled) restow(container, target, moves);
+        }
+        return emitSteps(container, target, moves);
     }
-    
-    vector<RetrievalStep> planRetrievalWithAStar(const string& containerId, const string& itemId) {
-        vector<RetrievalStep> steps;
-        
-        if (containers.find(containerId) == containers.end()) {
-            return steps;  //not found
+
+    // Algorithm policies for planWith. Dijkstra and A* both take the joint removal order as it
+    // comes, ACO reorders it for a shorter walk and exact also relocates blockers.
+    struct DijkstraPolicy {
+        static constexpr const char* name = "dijkstra";
+        static vector<Move> arrange(RetrievalPathPlanner&, const Container&, size_t, const vector<size_t>& blockingItems) {
+            return setAsideAll(blockingItems);
         }
-        
-        Container& container = containers[containerId];
-        
-        Item* targetItem = container.findItem(itemId);
-        if (!targetItem) {
-            return steps;  //not found
+    };
+
+    struct AStarPolicy {
+        static constexpr const char* name = "astar";
+        static vector<Move> arrange(RetrievalPathPlanner&, const Container&, size_t, const vector<size_t>& blockingItems) {
+            return setAsideAll(blockingItems);
         }
-        
-        if (isDirectlyAccessible(container, *targetItem)) {
-            steps.push_back(RetrievalStep(1, "retrieve", targetItem->id, targetItem->name));
-            return steps;
+    };
+
+    struct AcoPolicy {
+        static constexpr const char* name = "aco";
+        static vector<Move> arrange(RetrievalPathPlanner& planner, const Container& container, size_t target, const vector<size_t>& blockingItems) {
+            return planner.arrangeWithACO(container, target, blockingItems);
         }
-        
-        vector<Item> blockingItems = findOptimalRemovalSequence(container, *targetItem);
-        
-        int stepCount = 1;
-        
-        for (const auto& item : blockingItems) {
-            steps.push_back(RetrievalStep(stepCount++, "remove", item.id, item.name));
-            steps.push_back(RetrievalStep(stepCount++, "setAside", item.id, item.name));
+    };
+
+    struct ExactPolicy {
+        static constexpr const char* name = "exact";
+        static vector<Move> arrange(RetrievalPathPlanner& planner, const Container& container, size_t target, const vector<size_t>& blockingItems) {
+            return planner.arrangeExact(container, target, blockingItems);
         }
-        
-        steps.push_back(RetrievalStep(stepCount++, "retrieve", targetItem->id, targetItem->name));
-        
-        for (auto it = blockingItems.rbegin(); it != blockingItems.rend(); ++it) {
-            steps.push_back(RetrievalStep(stepCount++, "placeBack", it->id, it->name));
+    };
+
+    // Uniform [0, 1) draw for (iteration, ant, step) under a seed. Being a pure function of its
+    // counters it gives every ant its own stream and the same plan however ants are scheduled.
+    static double acoRandom(uint64_t seed, uint64_t iteration, uint64_t ant, uint64_t step) {
+        uint64_t z = seed ^ (iteration * 0x9E3779B97F4A7C15ULL) ^ (ant * 0xC2B2AE3D27D4EB4FULL) ^ (step * 0x165667B19E3779F9ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;   // splitmix64 finalizer
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Orders the target's blockers to shorten the crew's walk between them. Ants only pick items
+    // whose own blockers are already out, so every path is a valid removal order; pheromone sits on
+    // (previous item, next item) edges in one flat array, with row b for the starting move.
+    vector<Move> arrangeWithACO(const Container& container, size_t target, const vector<size_t>& blockingItems) {
+        // Local indices 0..b-1 for the blockers, with their DAG edges and positions
+        const size_t b = blockingItems.size();
+        unordered_map<size_t, int> localIndex;
+        for (size_t i = 0; i < b; ++i) localIndex[blockingItems[i]] = static_cast<int>(i);
+        vector<int> initialPending(b);
+        vector<vector<int>> successors(b);
+        vector<Position> positions(b);
+        for (size_t i = 0; i < b; ++i) {
+            size_t index = blockingItems[i];
+            initialPending[i] = static_cast<int>(container.blockers[index].size());
+            for (size_t next : container.blocked[index]) {
+                auto it = localIndex.find(next);
+                if (it != localIndex.end()) successors[i].push_back(it->second);
+            }
+            positions[i] = container.items[index].position;
         }
-        
-        return steps;
+        const Position start(container.items[target].position.x, 0, container.items[target].position.z);
+        auto distance = [](const Position& a, const Position& c) {
+            return static_cast<double>(abs(a.x - c.x) + abs(a.y - c.y) + abs(a.z - c.z));
+        };
+        auto from = [&](int previous) -> const Position& {
+            return previous < 0 ? start : positions[previous];
+        };
+
+        const AcoSettings& settings = acoSettings;
+        vector<double> pheromones((b + 1) * b, 1.0);
+        auto row = [b](int previous) { return (previous < 0 ? b : static_cast<size_t>(previous)) * b; };
+
+        auto runAnt = [&](int iteration, int ant, vector<int>& path) {
+            vector<int> pending = initialPending;
+            vector<int> ready;
+            for (size_t i = 0; i < b; ++i) {
+                if (pending[i] == 0) ready.push_back(static_cast<int>(i));
+            }
+            vector<double> weights;
+            path.clear();
+            int previous = -1;
+            while (!ready.empty()) {
+                weights.resize(ready.size());
+                double total = 0.0;
+                for (size_t r = 0; r < ready.size(); ++r) {
+                    double heuristic = 1.0 / (1.0 + distance(from(previous), positions[ready[r]]));
+                    weights[r] = pow(pheromones[row(previous) + ready[r]], settings.alpha) * pow(heuristic, settings.beta);
+                    total += weights[r];
+                }
+
+                double randomValue = acoRandom(settings.seed, iteration, ant, path.size()) * total;
+                size_t chosen = ready.size() - 1;
+                for (size_t r = 0; r < ready.size(); ++r) {
+                    randomValue -= weights[r];
+                    if (randomValue < 0.0) {
+                        chosen = r;
+                        break;
+                    }
+                }
+
+                int next = ready[chosen];
+                ready[chosen] = ready.back();
+                ready.pop_back();
+                path.push_back(next);
+                for (int successor : successors[next]) {
+                    if (--pending[successor] == 0) ready.push_back(successor);
+                }
+                previous = next;
+            }
+        };
+        auto pathCost = [&](const vector<int>& path) {
+            double cost = 0.0;
+            int previous = -1;
+            for (int next : path) {
+                cost += distance(from(previous), positions[next]);
+                previous = next;
+            }
+            return cost;
+        };
+
+        const int numAnts = settings.numAnts;
+        size_t workers = b >= settings.parallelThreshold
+            ? min<size_t>(numAnts, max(1u, settings.threads ? settings.threads : thread::hardware_concurrency()))
+            : 1;
+        vector<vector<int>> antPaths(numAnts);
+        vector<int> bestPath;
+        double bestCost = numeric_limits<double>::infinity();
+        int sinceImprovement = 0;
+
+        // Workers start once per run; each iteration hands them its ants and waits for all of them
+        // before the pheromone update, which reads every path
+        unique_ptr<ThreadPool> pool;
+        if (workers > 1) pool = make_unique<ThreadPool>(static_cast<unsigned>(workers));
+        int iteration = 0;
+        const function<void(size_t)> runIterationAnt = [&](size_t ant) {
+            runAnt(iteration, static_cast<int>(ant), antPaths[ant]);
+        };
+
+        for (; iteration < settings.maxIterations; ++iteration) {
+            if (pool) {
+                pool->parallelFor(numAnts, runIterationAnt);
+            } else {
+                for (int ant = 0; ant < numAnts; ++ant) runAnt(iteration, ant, antPaths[ant]);
+            }
+
+            for (double& pheromone : pheromones) pheromone *= 1.0 - settings.evaporationRate;
+
+            bool improved = false;
+            for (const auto& path : antPaths) {
+                double cost = pathCost(path);
+                double deposit = 1.0 / (1.0 + cost);
+                int previous = -1;
+                for (int next : path) {
+                    pheromones[row(previous) + next] += deposit;
+                    previous = next;
+                }
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestPath = path;
+                    improved = true;
+                }
+            }
+
+            // Converged once the best path has stood for `patience` iterations
+            sinceImprovement = improved ? 0 : sinceImprovement + 1;
+            if (sinceImprovement >= settings.patience) break;
+        }
+
+        vector<Move> moves;
+        for (int local : bestPath) moves.push_back({blockingItems[local], nullopt});
+        return moves;
     }
+    
+    // Slot finder: for each shape among shapeItems, the far end of the empty lane in front of every
+    // anchor on the anchorItems' edges, skipping slots that would stand in front of keepClear.
+    // Deepest first, at most `limit`.
+    static vector<geom::FixedBox> findFreeSlots(const Container& container, const vector<size_t>& anchorItems,
+                                                const vector<size_t>& shapeItems, size_t limit, const geom::FixedBox* keepClear) {
+        vector<geom::Coord> xs{0}, zs{0};
+        for (size_t index : anchorItems) {
+            geom::FixedBox box = container.items[index].box();
+            xs.push_back(box.maxX());
+            zs.push_back(box.maxZ());
+        }
+        for (auto* values : {&xs, &zs}) {
+            sort(values->begin(), values->end());
+            values->erase(unique(values->begin(), values->end()), values->end());
+        }
+        vector<tuple<geom::Coord, geom::Coord, geom::Coord>> shapes;
+        for (size_t index : shapeItems) {
+            const Item& item = container.items[index];
+            shapes.emplace_back(item.width, item.depth, item.height);
+        }
+        sort(shapes.begin(), shapes.end());
+        shapes.erase(unique(shapes.begin(), shapes.end()), shapes.end());
 
-    bool isDirectlyAccessible(const Container& container, const Item& item) {
-        if (item.position.y == 0) return true;
-        
-        for (const auto& otherItem : container.items) {
-            if (otherItem.id == item.id) continue; 
-            
-            if (otherItem.blocksPath(item.position)) {
-                return false; 
+        vector<geom::FixedBox> freeSlots;
+        for (const auto& [w, d, h] : shapes) {
+            for (geom::Coord x : xs) {
+                for (geom::Coord z : zs) {
+                    if (x + w > container.width || z + h > container.height) continue;
+                    geom::Coord freeDepth = container.laneFreeDepth(geom::FixedBox(x, 0, z, w, container.depth, h));
+                    if (freeDepth < d) continue;
+                    geom::FixedBox slot(x, freeDepth - d, z, w, d, h);
+                    if (!keepClear || !slot.blocks(*keepClear)) freeSlots.push_back(slot);
+                }
             }
         }
-        
-        return true; 
+        auto key = [](const geom::FixedBox& box) {
+            return make_tuple(-box.y, box.x, box.z, box.width, box.depth, box.height);
+        };
+        sort(freeSlots.begin(), freeSlots.end(), [&](const geom::FixedBox& a, const geom::FixedBox& c) { return key(a) < key(c); });
+        freeSlots.erase(unique(freeSlots.begin(), freeSlots.end(), [&](const geom::FixedBox& a, const geom::FixedBox& c) { return key(a) == key(c); }),
+                        freeSlots.end());
+        freeSlots.resize(min(freeSlots.size(), limit));
+        return freeSlots;
     }
-    vector<Item> findOptimalRemovalSequence(const Container& container, const Item& targetItem) {
-        return findBlockingItems(container, targetItem);
+
+    // Re-stow: chooses where each set-aside blocker goes back so that likely-wanted items end up with
+    // little in front of them. Blockers are placed by priority score, highest first, each into the
+    // open slot (its own spot, another set-aside blocker's spot or a free lane end from the slot
+    // finder) that adds the least expected retrieval cost: its own score for every box left in front
+    // of it plus the score of every box it would stand in front of. Own spots win ties. Leaves the
+    // moves as they are if some blocker would be left without a slot or nothing would improve.
+    void restow(const Container& container, size_t target, vector<Move>& moves) {
+        vector<size_t> setAside;
+        vector<bool> moved(container.items.size(), false);
+        moved[target] = true;
+        for (size_t k = 0; k < moves.size(); ++k) {
+            moved[moves[k].index] = true;
+            if (!moves[k].destination) setAside.push_back(k);
+        }
+        if (setAside.empty()) return;
+
+        // Everything that stays where it is: the items not touched and the relocated blockers
+        vector<pair<geom::FixedBox, double>> placed;
+        vector<geom::FixedBox> relocated;
+        for (size_t index = 0; index < container.items.size(); ++index) {
+            if (!moved[index]) placed.push_back({container.items[index].box(), container.items[index].priorityScore});
+        }
+        for (const Move& move : moves) {
+            if (!move.destination) continue;
+            const Item& item = container.items[move.index];
+            geom::FixedBox box(move.destination->x, move.destination->y, move.destination->z, item.width, item.depth, item.height);
+            placed.push_back({box, item.priorityScore});
+            relocated.push_back(box);
+        }
+
+        // The set-aside blockers' own spots first, then free lane ends nothing relocated stands in or before
+        vector<geom::FixedBox> slots;
+        vector<size_t> setAsideItems, anchors;
+        for (size_t k : setAside) {
+            slots.push_back(container.items[moves[k].index].box());
+            setAsideItems.push_back(moves[k].index);
+        }
+        anchors = setAsideItems;
+        anchors.push_back(target);
+        for (const auto& slot : findFreeSlots(container, anchors, setAsideItems, restowSettings.maxSlots, nullptr)) {
+            bool open = true;
+            for (const auto& box : relocated) {
+                if (box.overlaps(slot) || box.blocks(slot)) open = false;
+            }
+            if (open) slots.push_back(slot);
+        }
+
+        vector<size_t> order(setAside.size());
+        for (size_t r = 0; r < order.size(); ++r) order[r] = r;
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return container.items[setAsideItems[a]].priorityScore > container.items[setAsideItems[b]].priorityScore;
+        });
+
+        vector<pair<geom::FixedBox, double>> fixedBoxes = placed;
+        vector<bool> taken(slots.size(), false);
+        vector<int> chosen(setAside.size(), -1);
+        double restowCost = 0.0;
+        for (size_t r : order) {
+            const Item& item = container.items[setAsideItems[r]];
+            double bestCost = numeric_limits<double>::infinity();
+            for (size_t candidate = 0; candidate <= slots.size(); ++candidate) {
+                // Own spot first, then the rest in order
+                size_t s = candidate == 0 ? r : candidate - 1;
+                if (candidate > 0 && s == r) continue;
+                if (s >= slots.size() || taken[s]) continue;
+                const geom::FixedBox& slot = slots[s];
+                if (item.width > slot.width || item.depth > slot.depth || item.height > slot.height) continue;
+                geom::FixedBox box(slot.x, slot.y, slot.z, item.width, item.depth, item.height);
+
+                double cost = 0.0;
+                bool fits = true;
+                for (const auto& [other, score] : placed) {
+                    if (other.overlaps(box)) {
+                        fits = false;
+                        break;
+                    }
+                    if (other.blocks(box)) cost += item.priorityScore;
+                    else if (box.blocks(other)) cost += score;
+                }
+                if (fits && cost < bestCost) {
+                    bestCost = cost;
+                    chosen[r] = static_cast<int>(s);
+                }
+            }
+            if (chosen[r] < 0) return;
+
+            const geom::FixedBox& slot = slots[chosen[r]];
+            taken[chosen[r]] = true;
+            placed.push_back({geom::FixedBox(slot.x, slot.y, slot.z, item.width, item.depth, item.height), item.priorityScore});
+            restowCost += bestCost;
+        }
+
+        // The same cost with every blocker back in its own spot
+        double originalCost = 0.0;
+        for (size_t r = 0; r < setAside.size(); ++r) {
+            const Item& item = container.items[setAsideItems[r]];
+            geom::FixedBox box = item.box();
+            for (const auto& [other, score] : fixedBoxes) {
+                if (other.blocks(box)) originalCost += item.priorityScore;
+                else if (box.blocks(other)) originalCost += score;
+            }
+            fixedBoxes.push_back({box, item.priorityScore});
+        }
+        if (restowCost >= originalCost) return;
+
+        for (size_t r = 0; r < setAside.size(); ++r) {
+            if (chosen[r] == static_cast<int>(r)) continue;
+            const geom::FixedBox& slot = slots[chosen[r]];
+            moves[setAside[r]].returnTo = Position(slot.x, slot.y, slot.z);
+        }
     }
-    
-    // vector<RetrievalStep> planRetrievalWithACO(const string& containerId, const string& itemId) {
-    //     // This would be a more complex implementation using Ant Colony Optimization
-    //     // For simplicity, we'll just call the Dijkstra implementation for now
-    //     // return planRetrievalWithDijkstra(containerId, itemId);
 
-    // }
+    // Minimum-move plan by branch and bound. Each blocker either goes out and comes back (setAside
+    // and placeBack, two moves) or is relocated in one move to a slot inside the container: the far
+    // end of an empty lane, or the spot left by a blocker that was itself relocated. A relocated item
+    // may not stand in front of the target or of any involved item that stays or comes back, and no
+    // two relocations share a footprint on the open face, so nothing placed ever moves again. Which
+    // slots are open depends on what is already out, so the search runs over removal orders, with
+    // states memoized on their removed, relocated and used-slot bitsets and pruned by the bound "two
+    // moves per blocker still in, less one per blocker a matching can still give a slot". Past the
+    // ExactSettings limits it falls back to the A* plan.
+    vector<Move> arrangeExact(const Container& container, size_t target, const vector<size_t>& blockingItems) {
+        const ExactSettings& settings = exactSettings;
+        const auto started = chrono::steady_clock::now();
+        const size_t b = blockingItems.size();
+        if (b > min<size_t>(settings.maxBlockers, 32)) {
+            return AStarPolicy::arrange(*this, container, target, blockingItems);
+        }
 
-    vector<RetrievalStep> planRetrievalWithACO(const string& containerId, const string& itemId) {
-        vector<RetrievalStep> steps;
-    
-        if (containers.find(containerId) == containers.end()) {
-            return steps;
+        // Local DAG as bitmasks: blockerMask[i] holds the blockers that must be out before i moves
+        unordered_map<size_t, int> localIndex;
+        for (size_t i = 0; i < b; ++i) localIndex[blockingItems[i]] = static_cast<int>(i);
+        vector<uint32_t> blockerMask(b, 0);
+        vector<geom::FixedBox> boxes(b);
+        for (size_t i = 0; i < b; ++i) {
+            for (size_t blocker : container.blockers[blockingItems[i]]) {
+                blockerMask[i] |= uint32_t(1) << localIndex.at(blocker);
+            }
+            boxes[i] = container.items[blockingItems[i]].box();
         }
-    
-        Container& container = containers[containerId];
-    
-        Item* targetItem = container.findItem(itemId);
-        if (!targetItem) {
-            return steps;
+        const geom::FixedBox targetBox = container.items[target].box();
+
+        // Free lane ends from the slot finder, then every blocker's own spot
+        struct Slot {
+            geom::FixedBox box;
+            int vacatedBy;   // local blocker whose spot this is, or -1
+        };
+        vector<Slot> slots;
+        vector<size_t> anchors(blockingItems);
+        anchors.push_back(target);
+        for (const auto& box : findFreeSlots(container, anchors, blockingItems, min<size_t>(settings.maxSlots, 32), &targetBox)) {
+            slots.push_back({box, -1});
         }
-    
-        if (isDirectlyAccessible(container, *targetItem)) {
-            steps.push_back(RetrievalStep(1, "retrieve", targetItem->id, targetItem->name));
-            return steps;
+        for (size_t i = 0; i < b; ++i) slots.push_back({boxes[i], static_cast<int>(i)});
+
+        // Every slot each blocker fits, with the other blockers the placed item would stand in front of
+        struct Option {
+            int slot;
+            uint32_t blocksMask;
+        };
+        vector<vector<Option>> options(b);
+        for (size_t i = 0; i < b; ++i) {
+            for (size_t s = 0; s < slots.size(); ++s) {
+                const geom::FixedBox& slot = slots[s].box;
+                if (slots[s].vacatedBy == static_cast<int>(i)) continue;
+                if (boxes[i].width > slot.width || boxes[i].depth > slot.depth || boxes[i].height > slot.height) continue;
+                geom::FixedBox placed(slot.x, slot.y, slot.z, boxes[i].width, boxes[i].depth, boxes[i].height);
+                if (placed.blocks(targetBox)) continue;
+                uint32_t mask = 0;
+                for (size_t j = 0; j < b; ++j) {
+                    if (j != i && placed.blocks(boxes[j])) mask |= uint32_t(1) << j;
+                }
+                options[i].push_back({static_cast<int>(s), mask});
+            }
         }
-    
-        vector<Item> blockingItems = findBlockingItems(container, *targetItem);
-    
-        if (blockingItems.empty()) {
-            steps.push_back(RetrievalStep(1, "retrieve", targetItem->id, targetItem->name));
-            return steps;
+        vector<uint64_t> conflicts(slots.size(), 0);
+        for (size_t s = 0; s < slots.size(); ++s) {
+            for (size_t t = 0; t < slots.size(); ++t) {
+                if (s != t && slots[s].box.overlapsFace(slots[t].box)) conflicts[s] |= uint64_t(1) << t;
+            }
         }
-    
-        int stepCount = 1;
-    
-        unordered_map<string, double> pheromones;
-        for (const auto& item : blockingItems) {
-            pheromones[item.id] = 1.0;
+
+        // last is the previous move as blocker * 2 + relocated, or -1 at the start
+        struct State {
+            uint32_t removed;
+            uint32_t relocated;
+            uint64_t used;
+            int last;
+            bool operator==(const State& other) const {
+                return removed == other.removed && relocated == other.relocated && used == other.used && last == other.last;
+            }
+        };
+        struct StateHash {
+            size_t operator()(const State& state) const {
+                uint64_t z = (uint64_t(state.removed) << 32 | state.relocated) ^ (state.used * 0x9E3779B97F4A7C15ULL) ^ uint64_t(state.last + 1);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                return static_cast<size_t>(z ^ (z >> 31));
+            }
+        };
+        // cost is exact, or only a lower bound when the search below it was cut off by its limit
+        struct Entry {
+            int cost;
+            bool exact;
+            int blocker;
+            int slot;   // -1 = setAside
+        };
+
+        const uint32_t all = b == 32 ? ~uint32_t(0) : (uint32_t(1) << b) - 1;
+        unordered_map<State, Entry, StateHash> memo;
+        constexpr int UNREACHABLE = 1 << 20;
+        size_t nodes = 0;
+        bool outOfTime = false;
+
+        // Slots grouped into cliques of the conflict graph: a clique holds at most one relocation
+        vector<uint64_t> cliques;
+        vector<int> cliqueOf(slots.size());
+        for (size_t s = 0; s < slots.size(); ++s) {
+            size_t c = 0;
+            while (c < cliques.size() && (cliques[c] & ~conflicts[s])) ++c;
+            if (c == cliques.size()) cliques.push_back(0);
+            cliques[c] |= uint64_t(1) << s;
+            cliqueOf[s] = static_cast<int>(c);
         }
-    
-        const int numAnts = 10;
-        const int numIterations = 100;
-        const double evaporationRate = 0.5;
-        const double alpha = 1.0; //pheromone
-        const double beta = 2.0;  //proximity
-    
-        for (int iteration = 0; iteration < numIterations; ++iteration) {
-            vector<vector<Item>> antPaths(numAnts);
-    
-            for (int ant = 0; ant < numAnts; ++ant) {
-                unordered_set<string> visited;
-                vector<Item> path;
-    
-                while (path.size() < blockingItems.size()) {
-                    vector<pair<Item, double>> probabilities;
-    
-                    for (const auto& item : blockingItems) {
-                        if (visited.count(item.id)) continue;
-    
-                        double pheromone = pheromones[item.id];
-                        double heuristic = 1.0 / (1 + abs(item.position.y - targetItem->position.y));
-                        double probability = pow(pheromone, alpha) * pow(heuristic, beta);
-                        probabilities.push_back({item, probability});
+
+        // Most blockers still in that can yet be relocated: a matching of blockers to cliques holding a
+        // slot of theirs that is free, clear of the used ones and, if it is a blocker's spot, not taken
+        // by a blocker that stays or comes back
+        auto relocatable = [&](const State& state) {
+            // Narrowed to a fixpoint, since a slot also needs whatever it stands in front of relocated
+            uint32_t candidates = all & ~state.removed;
+            vector<uint64_t> reachable(b, 0);
+            for (bool changed = true; changed;) {
+                changed = false;
+                uint32_t mayRelocate = state.relocated | candidates;
+                for (size_t i = 0; i < b; ++i) {
+                    if (!(candidates >> i & 1)) continue;
+                    reachable[i] = 0;
+                    for (const Option& option : options[i]) {
+                        const Slot& slot = slots[option.slot];
+                        if (state.used & ((uint64_t(1) << option.slot) | conflicts[option.slot])) continue;
+                        if (slot.vacatedBy >= 0 && !(mayRelocate >> slot.vacatedBy & 1)) continue;
+                        if (option.blocksMask & ~mayRelocate) continue;
+                        reachable[i] |= uint64_t(1) << cliqueOf[option.slot];
                     }
-    
-                    double totalProbability = 0.0;
-                    for (const auto& p : probabilities) {
-                        totalProbability += p.second;
+                    if (!reachable[i]) {
+                        candidates &= ~(uint32_t(1) << i);
+                        changed = true;
                     }
-    
-                    double randomValue = ((double)rand() / RAND_MAX) * totalProbability;
-                    double cumulativeProbability = 0.0;
-    
-                    for (const auto& p : probabilities) {
-                        cumulativeProbability += p.second;
-                        if (randomValue <= cumulativeProbability) {
-                            path.push_back(p.first);
-                            visited.insert(p.first.id);
-                            break;
-                        }
+                }
+            }
+
+            vector<int> matchedTo(cliques.size(), -1);
+            auto augment = [&](auto& self, size_t i, uint64_t& seen) -> bool {
+                for (uint64_t open = reachable[i] & ~seen; open; open &= open - 1) {
+                    int c = countr_zero(open);
+                    seen |= uint64_t(1) << c;
+                    if (matchedTo[c] < 0 || self(self, matchedTo[c], seen)) {
+                        matchedTo[c] = static_cast<int>(i);
+                        return true;
                     }
                 }
-    
-                antPaths[ant] = path;
+                return false;
+            };
+            int matched = 0;
+            for (size_t i = 0; i < b; ++i) {
+                uint64_t seen = 0;
+                if (reachable[i] && augment(augment, i, seen)) ++matched;
             }
-    
-            unordered_map<string, double> newPheromones;
-            for (const auto& item : blockingItems) {
-                newPheromones[item.id] = pheromones[item.id] * (1 - evaporationRate);
+            return matched;
+        };
+
+        // Independent moves commute, so of two in a row only the order with setAsides before
+        // relocations, then lower blockers first, is searched; a move that needs the previous one out
+        // of the way (its blocker, its slot, or an item its slot stands in front of) may always follow
+        auto inOrder = [&](const State& state, size_t i, const Option* option) {
+            if (state.last < 0) return true;
+            size_t previous = state.last >> 1;
+            bool previousRelocated = state.last & 1;
+            bool dependent = (blockerMask[i] >> previous & 1) ||
+                             (previousRelocated && option &&
+                              (slots[option->slot].vacatedBy == static_cast<int>(previous) || (option->blocksMask >> previous & 1)));
+            return dependent || make_pair(previousRelocated, previous) < make_pair(option != nullptr, i);
+        };
+
+        // Cheapest way to get the remaining blockers out from `state`: exact when below `limit`,
+        // otherwise a lower bound of at least `limit`
+        auto search = [&](auto& self, const State& state, int limit) -> int {
+            if (state.removed == all) return 0;
+            if ((++nodes & 1023) == 0 &&
+                chrono::duration<double, milli>(chrono::steady_clock::now() - started).count() > settings.timeBudgetMs) {
+                outOfTime = true;
             }
-    
-            for (const auto& path : antPaths) {
-                double pathQuality = 1.0 / path.size();
-                for (const auto& item : path) {
-                    newPheromones[item.id] += pathQuality;
+            if (outOfTime) return limit;
+
+            uint32_t left = all & ~state.removed;
+            int bound = 2 * popcount(left) - relocatable(state);
+            auto it = memo.find(state);
+            if (it != memo.end()) {
+                if (it->second.exact) return it->second.cost;
+                bound = max(bound, it->second.cost);
+            }
+            if (bound >= limit) return bound;
+
+            // Stays out of reach when the move order rules out every continuation
+            int best = UNREACHABLE;
+            int bestBlocker = -1, bestSlot = -1;
+            for (size_t i = 0; i < b; ++i) {
+                uint32_t bit = uint32_t(1) << i;
+                if (!(left & bit) || (blockerMask[i] & left)) continue;
+                uint32_t removed = state.removed | bit;
+
+                // Relocations first: the cheap branch tightens the bound for the rest
+                for (const Option& option : options[i]) {
+                    const Slot& slot = slots[option.slot];
+                    uint64_t slotBit = uint64_t(1) << option.slot;
+                    if (state.used & (slotBit | conflicts[option.slot])) continue;
+                    if (slot.vacatedBy >= 0 && !(state.relocated >> slot.vacatedBy & 1)) continue;
+                    uint32_t relocated = state.relocated | bit;
+                    if ((option.blocksMask & ~relocated) || !inOrder(state, i, &option)) continue;
+
+                    int cost = 1 + self(self, State{removed, relocated, state.used | slotBit, static_cast<int>(i * 2 + 1)},
+                                        min(limit, best) - 1);
+                    if (cost < best) {
+                        best = cost;
+                        bestBlocker = static_cast<int>(i);
+                        bestSlot = option.slot;
+                    }
+                }
+
+                if (!inOrder(state, i, nullptr)) continue;
+                int cost = 2 + self(self, State{removed, state.relocated, state.used, static_cast<int>(i * 2)}, min(limit, best) - 2);
+                if (cost < best) {
+                    best = cost;
+                    bestBlocker = static_cast<int>(i);
+                    bestSlot = -1;
                 }
+                if (best <= bound) break;
+            }
+
+            if (!outOfTime) memo[state] = {best, best < limit, bestBlocker, bestSlot};
+            return best;
+        };
+
+        // Taking blockers in removal order and relocating each to its first open slot gives the
+        // starting upper bound
+        int greedy = 0;
+        {
+            uint32_t relocated = 0;
+            uint64_t used = 0;
+            for (size_t i = 0; i < b; ++i) {
+                uint32_t bit = uint32_t(1) << i;
+                int cost = 2;
+                for (const Option& option : options[i]) {
+                    int vacatedBy = slots[option.slot].vacatedBy;
+                    if (used & ((uint64_t(1) << option.slot) | conflicts[option.slot])) continue;
+                    if ((vacatedBy >= 0 && !(relocated >> vacatedBy & 1)) || (option.blocksMask & ~(relocated | bit))) continue;
+                    relocated |= bit;
+                    used |= uint64_t(1) << option.slot;
+                    cost = 1;
+                    break;
+                }
+                greedy += cost;
             }
-    
-            pheromones = newPheromones;
         }
-    
-        vector<Item> optimalPath;
-        double maxPheromone = 0.0;
-        for (const auto& item : blockingItems) {
-            if (pheromones[item.id] > maxPheromone) {
-                maxPheromone = pheromones[item.id];
-                optimalPath.push_back(item);
+
+        const State start{0, 0, 0, -1};
+        search(search, start, greedy + 1);
+        if (outOfTime) {
+            return AStarPolicy::arrange(*this, container, target, blockingItems);
+        }
+
+        vector<Move> moves;
+        for (State state = start; state.removed != all;) {
+            const Entry& entry = memo.at(state);
+            uint32_t bit = uint32_t(1) << entry.blocker;
+            if (entry.slot < 0) {
+                moves.push_back({blockingItems[entry.blocker], nullopt});
+                state = State{state.removed | bit, state.relocated, state.used, entry.blocker * 2};
+            } else {
+                const geom::FixedBox& slot = slots[entry.slot].box;
+                moves.push_back({blockingItems[entry.blocker], Position(slot.x, slot.y, slot.z)});
+                state = State{state.removed | bit, state.relocated | bit, state.used | (uint64_t(1) << entry.slot), entry.blocker * 2 + 1};
             }
         }
+        return moves;
+    }
     
-        for (const auto& item : optimalPath) {
-            steps.push_back(RetrievalStep(stepCount++, "remove", item.id, item.name));
-            steps.push_back(RetrievalStep(stepCount++, "setAside", item.id, item.name));
+public:
+    // Plans one sequence retrieving every listed item: each blocker is removed and set aside once,
+    // even when it stands in front of several targets, each target is retrieved as soon as nothing
+    // blocks it, and blockers go back in reverse removal order at the end. Unknown IDs are skipped.
+    vector<RetrievalStep> planBatchRetrieval(const string& containerId, const vector<string>& itemIds) {
+        vector<RetrievalStep> steps;
+
+        auto containerIt = containers.find(containerId);
+        if (containerIt == containers.end()) {
+            return steps;
         }
-    
-        steps.push_back(RetrievalStep(stepCount++, "retrieve", targetItem->id, targetItem->name));
-    
-        for (auto it = optimalPath.rbegin(); it != optimalPath.rend(); ++it) {
-            steps.push_back(RetrievalStep(stepCount++, "placeBack", it->id, it->name));
+        Container& container = containerIt->second;
+
+        vector<size_t> targets;
+        unordered_set<size_t> isTarget;
+        for (const auto& itemId : itemIds) {
+            Item* item = container.findItem(itemId);
+            if (item && isTarget.insert(container.indexOf(*item)).second) {
+                targets.push_back(container.indexOf(*item));
+            }
         }
-    
+        if (targets.empty()) {
+            return steps;
+        }
+
+        int stepCount = 1;
+        vector<size_t> setAside;
+        for (size_t index : jointRemovalOrder(container, targets)) {
+            const Item& item = container.items[index];
+            if (isTarget.count(index)) {
+                steps.push_back(RetrievalStep(stepCount++, "retrieve", item.id, item.name));
+            } else {
+                steps.push_back(RetrievalStep(stepCount++, "remove", item.id, item.name));
+                steps.push_back(RetrievalStep(stepCount++, "setAside", item.id, item.name));
+                setAside.push_back(index);
+            }
+        }
+
+        for (auto it = setAside.rbegin(); it != setAside.rend(); ++it) {
+            const Item& item = container.items[*it];
+            steps.push_back(RetrievalStep(stepCount++, "placeBack", item.id, item.name));
+        }
+
         return steps;
     }
-    
-public:
+
     void addContainer(const Container& container) {
         containers[container.id] = container;
     }
+
+    void setAcoSettings(const AcoSettings& settings) {
+        acoSettings = settings;
+    }
+
+    void setExactSettings(const ExactSettings& settings) {
+        exactSettings = settings;
+    }
+
+    void setRestowSettings(const RestowSettings& settings) {
+        restowSettings = settings;
+    }
+
+    PlanCache& getPlanCache() {
+        return planCache;
+    }
     
     bool addItemToContainer(const string& containerId, const Item& item) {
         if (containers.find(containerId) == containers.end()) {
@@ -426,14 +1398,48 @@ public:
         return true;
     }
 
-    vector<RetrievalStep> planRetrieval(const string& containerId, const string& itemId, const string& algorithm = "astar") {
-        if (algorithm == "astar") {
-            return planRetrievalWithAStar(containerId, itemId);
-        } else if (algorithm == "aco") {
-            return planRetrievalWithACO(containerId, itemId);
-        } else {
-            return planRetrievalWithDijkstra(containerId, itemId);
+    bool removeItemFromContainer(const string& containerId, const string& itemId) {
+        auto it = containers.find(containerId);
+        return it != containers.end() && it->second.removeItem(itemId);
+    }
+
+    // A planner core instantiation and its name; look one up once with findAlgorithm
+    struct Algorithm {
+        const char* name;
+        vector<RetrievalStep> (RetrievalPathPlanner::*plan)(const string& containerId, const string& itemId);
+    };
+
+    // Unknown names plan with dijkstra, as before
+    static const Algorithm& findAlgorithm(const string& name) {
+        static const Algorithm registry[] = {
+            {DijkstraPolicy::name, &RetrievalPathPlanner::planWith<DijkstraPolicy>},
+            {AStarPolicy::name, &RetrievalPathPlanner::planWith<AStarPolicy>},
+            {AcoPolicy::name, &RetrievalPathPlanner::planWith<AcoPolicy>},
+            {ExactPolicy::name, &RetrievalPathPlanner::planWith<ExactPolicy>},
+        };
+        for (const Algorithm& algorithm : registry) {
+            if (name == algorithm.name) return algorithm;
+        }
+        return registry[0];
+    }
+
+    vector<RetrievalStep> planRetrieval(const string& containerId, const string& itemId, const Algorithm& algorithm) {
+        auto containerIt = containers.find(containerId);
+        if (containerIt == containers.end()) {
+            return {};
         }
+        string cacheKey = PlanCache::key(containerId, containerIt->second.version, itemId, algorithm.name, settingsDigest());
+        if (const vector<RetrievalStep>* cached = planCache.get(cacheKey)) {
+            return *cached;
+        }
+
+        vector<RetrievalStep> steps = (this->*algorithm.plan)(containerId, itemId);
+        if (!steps.empty()) planCache.put(cacheKey, steps);
+        return steps;
+    }
+
+    vector<RetrievalStep> planRetrieval(const string& containerId, const string& itemId, const string& algorithm = "astar") {
+        return planRetrieval(containerId, itemId, findAlgorithm(algorithm));
     }
     
     const unordered_map<string, Container>& getContainers() const {
@@ -443,9 +1449,80 @@ public:
 
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <random>
 #include "json.hpp"
 using json = nlohmann::json;
 
+// The store behind "planCachePath": a JSON array of {"key", "steps"} entries, most recently used
+// first. A missing or unreadable store leaves the cache empty, malformed entries are skipped.
+void loadPlanCache(PlanCache& cache, const string& path) {
+    ifstream in(path);
+    if (!in) return;
+    json stored = json::parse(in, nullptr, false);
+    if (!stored.is_array()) return;
+
+    for (auto entry = stored.rbegin(); entry != stored.rend(); ++entry) {
+        if (!entry->is_object() || !entry->contains("key") || !(*entry)["key"].is_string() ||
+            !entry->contains("steps") || !(*entry)["steps"].is_array()) continue;
+        vector<RetrievalStep> steps;
+        try {
+            for (const auto& step : (*entry)["steps"]) {
+                optional<Position> destination;
+                if (step.contains("destination")) {
+                    const json& corner = step.at("destination");
+                    destination = Position(corner.at(0).get<geom::Coord>(), corner.at(1).get<geom::Coord>(), corner.at(2).get<geom::Coord>());
+                }
+                steps.push_back(RetrievalStep(step.at("stepNumber").get<int>(), step.at("action").get<string>(),
+                                              step.at("itemId").get<string>(), step.at("itemName").get<string>(), destination));
+            }
+        } catch (const json::exception&) {
+            continue;
+        }
+        cache.put((*entry)["key"].get<string>(), steps);
+    }
+    cache.markSaved();
+}
+
+// Written through a temporary file and a rename, so a concurrent planner never reads half a store.
+// Concurrent writers simply race; the last rename wins.
+void savePlanCache(PlanCache& cache, const string& path) {
+    if (!cache.dirty()) return;
+
+    json stored = json::array();
+    for (const auto& [key, steps] : cache.contents()) {
+        json stepsJson = json::array();
+        for (const auto& step : steps) {
+            json stepJson = {{"stepNumber", step.stepNumber}, {"action", step.action},
+                             {"itemId", step.itemId}, {"itemName", step.itemName}};
+            if (step.destination) {
+                stepJson["destination"] = {step.destination->x, step.destination->y, step.destination->z};
+            }
+            stepsJson.push_back(stepJson);
+        }
+        stored.push_back({{"key", key}, {"steps", stepsJson}});
+    }
+
+    string temporary = path + ".tmp" + to_string(random_device{}());
+    {
+        ofstream out(temporary);
+        out << stored.dump();
+        if (!out) {
+            error_code ignored;
+            filesystem::remove(temporary, ignored);
+            return;
+        }
+    }
+    error_code error;
+    filesystem::rename(temporary, path, error);
+    if (error) {
+        filesystem::remove(temporary, error);
+        return;
+    }
+    cache.markSaved();
+}
+
 using namespace std;
 
 int main() {
@@ -499,22 +1576,40 @@ int main() {
 
     cout<<"Container: "<<container.dump(4)<<endl;
 
-    string itemId = inputJson["itemId"];
+    // Either a single "itemId" or an "itemIds" array planned jointly
+    vector<string> itemIds;
+    if (inputJson.contains("itemIds") && inputJson["itemIds"].is_array()) {
+        itemIds = inputJson["itemIds"].get<vector<string>>();
+    } else {
+        itemIds.push_back(inputJson["itemId"]);
+    }
 
-    cout<<"Item ID: "<<itemId<<endl;
+    cout<<"Item ID: "<<(itemIds.empty() ? string() : itemIds.front())<<endl;
     
     Container parsedContainer(
         container["containerId"],
         container["zone"],
-        container.value("width", 0),
-        container.value("depth", 0),
-        container.value("height", 0)
+        geom::Fixed::fromInput(container.value("width", 0.0)),
+        geom::Fixed::fromInput(container.value("depth", 0.0)),
+        geom::Fixed::fromInput(container.value("height", 0.0))
     );
 
     cout<<"Parsed Container: "<<parsedContainer.id<<endl;
 
+    // Optional "voxelSize" (input units) turns on the occupancy grid; non-positive sizes are ignored
+    if (inputJson.contains("voxelSize") && inputJson["voxelSize"].is_number()) {
+        geom::Coord voxelSize = geom::Fixed::fromInput(inputJson["voxelSize"].get<double>());
+        if (voxelSize > 0) {
+            parsedContainer.enableOccupancyGrid(voxelSize);
+        } else {
+            cerr << "Ignoring non-positive voxelSize" << endl;
+        }
+    }
+
     vector<json> item_data;
 
+    // Loaded in one batch so the blocking DAG is built by a single sweep
+    vector<Item> parsedItems;
     for (const auto& item : container["items"]) {
         cout<<"item: "<<item.dump(4)<<endl;
         json itemDetails = item;
@@ -523,19 +1618,24 @@ int main() {
                 itemDetails["itemId"],
                 itemDetails["name"],
                 Position(
-                    itemDetails["startPos"].value("x", 0),
-                    itemDetails["startPos"].value("y", 0),
-                    itemDetails["startPos"].value("z", 0)
+                    geom::Fixed::fromInput(itemDetails["startPos"].value("x", 0.0)),
+                    geom::Fixed::fromInput(itemDetails["startPos"].value("y", 0.0)),
+                    geom::Fixed::fromInput(itemDetails["startPos"].value("z", 0.0))
                 ),
-                itemDetails.value("width", 0),
-                itemDetails.value("depth", 0),
-                itemDetails.value("height", 0)
+                geom::Fixed::fromInput(itemDetails.value("width", 0.0)),
+                geom::Fixed::fromInput(itemDetails.value("depth", 0.0)),
+                geom::Fixed::fromInput(itemDetails.value("height", 0.0))
             );
 
+            if (itemDetails.contains("priorityScore") && itemDetails["priorityScore"].is_number()) {
+                item_x.priorityScore = itemDetails["priorityScore"].get<double>();
+            }
+
             cout<<item_x<<endl;
-            parsedContainer.addItem(item_x);
+            parsedItems.push_back(item_x);
         }
     }
+    parsedContainer.addItems(parsedItems);
 
     // cout<<"Item data: "<<item_data[0].dump(4)<<endl;
 
@@ -547,7 +1647,55 @@ int main() {
     planner.addContainer(parsedContainer);
 
     // Plan retrieval for an item
-    vector<RetrievalStep> steps = planner.planRetrieval(parsedContainer.id, itemId, "astar");
+    // Optional "algorithm" ("astar", "dijkstra", "aco" or "exact") and "seed" for reproducible ACO runs
+    const RetrievalPathPlanner::Algorithm& algorithm = RetrievalPathPlanner::findAlgorithm(
+        inputJson.contains("algorithm") && inputJson["algorithm"].is_string() ? inputJson["algorithm"].get<string>() : "astar");
+    if (inputJson.contains("seed") && inputJson["seed"].is_number_unsigned()) {
+        AcoSettings settings;
+        settings.seed = inputJson["seed"].get<uint64_t>();
+        planner.setAcoSettings(settings);
+    }
+
+    // Optional "exact": {"maxBlockers", "maxSlots", "timeBudgetMs"} bounds the exact solver
+    if (inputJson.contains("exact") && inputJson["exact"].is_object()) {
+        const json& limits = inputJson["exact"];
+        ExactSettings settings;
+        settings.maxBlockers = limits.contains("maxBlockers") && limits["maxBlockers"].is_number_unsigned() ? limits["maxBlockers"].get<size_t>() : settings.maxBlockers;
+        settings.maxSlots = limits.contains("maxSlots") && limits["maxSlots"].is_number_unsigned() ? limits["maxSlots"].get<size_t>() : settings.maxSlots;
+        settings.timeBudgetMs = limits.contains("timeBudgetMs") && limits["timeBudgetMs"].is_number() ? limits["timeBudgetMs"].get<double>() : settings.timeBudgetMs;
+        planner.setExactSettings(settings);
+    }
+
+    // Optional "restow": true lets set-aside blockers go back to better slots by "priorityScore"
+    if (inputJson.contains("restow") && inputJson["restow"].is_boolean()) {
+        RestowSettings settings;
+        settings.enabled = inputJson["restow"].get<bool>();
+        planner.setRestowSettings(settings);
+    }
+
+    // Optional "planCachePath" keeps plans between runs, "planCacheSize" bounds how many are kept
+    string planCachePath = inputJson.contains("planCachePath") && inputJson["planCachePath"].is_string() ? inputJson["planCachePath"].get<string>() : "";
+    if (inputJson.contains("planCacheSize") && inputJson["planCacheSize"].is_number_unsigned()) {
+        planner.getPlanCache().resize(inputJson["planCacheSize"].get<size_t>());
+    }
+    if (!planCachePath.empty()) {
+        loadPlanCache(planner.getPlanCache(), planCachePath);
+    }
+
+    vector<RetrievalStep> steps = itemIds.size() == 1
+        ? planner.planRetrieval(parsedContainer.id, itemIds.front(), algorithm)
+        : planner.planBatchRetrieval(parsedContainer.id, itemIds);
+
+    if (!planCachePath.empty()) {
+        savePlanCache(planner.getPlanCache(), planCachePath);
+    }
+
+    // Cache metrics go to stderr so stdout stays the plain step list
+    const PlanCache::Stats& cacheStats = planner.getPlanCache().stats();
+    json metrics;
+    metrics["planCache"] = {{"hits", cacheStats.hits}, {"misses", cacheStats.misses}, {"hitRate", cacheStats.hitRate()},
+                            {"entries", planner.getPlanCache().contents().size()}};
+    cerr << metrics.dump() << endl;
 
     if(steps.empty()){
         cout<<"No steps found for the given item."<<endl;
@@ -562,6 +1710,13 @@ int main() {
         stepJson["action"] = step.action;
         stepJson["itemId"] = step.itemId;
         stepJson["itemName"] = step.itemName;
+        if (step.destination) {
+            stepJson["toPosition"] = {
+                {"x", geom::Fixed::toInput(step.destination->x)},
+                {"y", geom::Fixed::toInput(step.destination->y)},
+                {"z", geom::Fixed::toInput(step.destination->z)}
+            };
+        }
         output.push_back(stepJson);
     }
 
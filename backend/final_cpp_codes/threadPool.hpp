@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run batches of indexed tasks; shared by the placement and
+// retrieval engines so neither spawns threads per batch
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t taskCount = 0;
+    std::atomic<size_t> nextIndex{0};
+    size_t activeWorkers = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+
+    void workerLoop() {
+        unsigned long long seenGeneration = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mtx);
+            workReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+            lock.unlock();
+
+            for (size_t i = nextIndex++; i < taskCount; i = nextIndex++) {
+                (*task)(i);
+            }
+
+            lock.lock();
+            if (--activeWorkers == 0) workDone.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(unsigned threadCount) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Runs fn(i) for every i in [0, count) on the workers and waits until all calls finish
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return;
+        std::unique_lock<std::mutex> lock(mtx);
+        task = &fn;
+        taskCount = count;
+        nextIndex = 0;
+        activeWorkers = workers.size();
+        ++generation;
+        workReady.notify_all();
+        workDone.wait(lock, [&] { return activeWorkers == 0; });
+        task = nullptr;
+    }
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include <climits>
 #include <fstream>
 #include "json.hpp"
+#include "geometryKernel.hpp"
 using namespace std;
 
 struct Item;
@@ -28,7 +29,7 @@ const chrono::system_clock::time_point CURRENT_DATE = []() {
 struct Item {
     string id;
     string name;
-    int width, depth, height;
+    geom::Coord width, depth, height; // fixed-point, see geometryKernel.hpp
     double mass;
     int priority;
     string expiryDate;
@@ -39,18 +40,22 @@ struct Item {
     Item(){}
     
     struct Position {
-        int x, y, z;
-        Position(int _x = 0, int _y = 0, int _z = 0) : x(_x), y(_y), z(_z) {}
+        geom::Coord x, y, z;
+        Position(geom::Coord _x = 0, geom::Coord _y = 0, geom::Coord _z = 0) : x(_x), y(_y), z(_z) {}
     } position;
     
-    Item(string _id, string _name, int w, int d, int h, double m, 
+    Item(string _id, string _name, geom::Coord w, geom::Coord d, geom::Coord h, double m, 
          int p, string exp, int usage, string pZone) 
         : id(_id), name(_name), width(w), depth(d), height(h), mass(m),
           priority(p), expiryDate(exp), usageLimit(usage), preferredZone(pZone),
           containerId(""), wasteReason("") {}
     
-    double volume() const {
-        return width * depth * height;
+    geom::FixedBox box() const {
+        return geom::FixedBox(position.x, position.y, position.z, width, depth, height);
+    }
+
+    geom::Volume volume() const {
+        return box().volume();
     }
     
     bool isExpired() const {
@@ -77,13 +82,13 @@ struct Item {
 struct Container {
     string id;
     string zone;
-    int width, depth, height;
+    geom::Coord width, depth, height;
     Container(){}
-    Container(string _id, string _zone, int w, int d, int h) 
+    Container(string _id, string _zone, geom::Coord w, geom::Coord d, geom::Coord h) 
         : id(_id), zone(_zone), width(w), depth(d), height(h) {}
     
-    double volume() const {
-        return width * depth * height;
+    geom::Volume volume() const {
+        return geom::FixedBox(0, 0, 0, width, depth, height).volume();
     }
 };
 
@@ -104,19 +109,26 @@ private:
         return diff / 24;
     }
     
-    bool isItemAccessible(const Item& item) const {
-        for (const auto& [id, otherItem] : itemsDatabase) {
-            if (id == item.id || otherItem.containerId != item.containerId) continue;
+    // Blocker count for every stored item, one sweep per container instead of a scan per item
+    unordered_map<string, int> blockerCounts() const {
+        unordered_map<string, vector<const Item*>> byContainer;
+        for (const auto& [id, item] : itemsDatabase) {
+            byContainer[item.containerId].push_back(&item);
+        }
+        
+        unordered_map<string, int> counts;
+        counts.reserve(itemsDatabase.size());
+        for (const auto& [containerId, items] : byContainer) {
+            vector<geom::FixedBox> boxes;
+            boxes.reserve(items.size());
+            for (const Item* item : items) boxes.push_back(item->box());
             
-            if (otherItem.position.y < item.position.y && 
-                otherItem.position.x < item.position.x + item.width && 
-                otherItem.position.x + otherItem.width > item.position.x &&
-                otherItem.position.z < item.position.z + item.height && 
-                otherItem.position.z + otherItem.height > item.position.z) {
-                return false;
+            vector<int> blockers = geom::countBlockers(boxes);
+            for (size_t i = 0; i < items.size(); ++i) {
+                counts[items[i]->id] = blockers[i];
             }
         }
-        return true;
+        return counts;
     }
     
     vector<Item> getBlockingItems(const Item& item) const {
@@ -125,11 +137,7 @@ private:
         for (const auto& [id, otherItem] : itemsDatabase) {
             if (id == item.id || otherItem.containerId != item.containerId) continue;
             
-            if (otherItem.position.y < item.position.y && 
-                otherItem.position.x < item.position.x + item.width && 
-                otherItem.position.x + otherItem.width > item.position.x &&
-                otherItem.position.z < item.position.z + item.height && 
-                otherItem.position.z + otherItem.height > item.position.z) {
+            if (otherItem.box().blocks(item.box())) {
                 blockingItems.push_back(otherItem);
             }
         }
@@ -146,7 +154,7 @@ public:
         containersDatabase[container.id] = container;
     }
     
-    void updateItemPosition(const string& itemId, const string& containerId, int x, int y, int z) {
+    void updateItemPosition(const string& itemId, const string& containerId, geom::Coord x, geom::Coord y, geom::Coord z) {
         if (itemsDatabase.find(itemId) != itemsDatabase.end()) {
             itemsDatabase[itemId].containerId = containerId;
             itemsDatabase[itemId].position.x = x;
@@ -199,7 +207,7 @@ public:
             string undockingContainerId;
             string undockingDate;
             vector<tuple<string, string, string>> returnItems; // itemId, name, reason
-            double totalVolume;
+            geom::Volume totalVolume;
             double totalWeight;
         };
         
@@ -223,6 +231,7 @@ public:
         
         int stepCount = 1;
         int retrievalStepCount = 1;
+        unordered_map<string, int> blockers = blockerCounts();
         
         for (const auto& item : wasteItems) {
             if (plan.manifest.totalWeight + item.mass > maxWeight) {
@@ -241,7 +250,7 @@ public:
             plan.manifest.totalVolume += item.volume();
             plan.manifest.totalWeight += item.mass;
             
-            if (!isItemAccessible(item)) {
+            if (blockers[item.id] > 0) {
                 vector<Item> blockingItems = getBlockingItems(item);
                 
                 for (const auto& blockingItem : blockingItems) {
@@ -320,7 +329,7 @@ public:
         
         ProcessedWaste result;
         result.itemId = item.id;
-        result.originalVolume = item.volume();
+        result.originalVolume = geom::Fixed::volumeToInput(item.volume());
         
         double waterContent = item.mass * 0.15;
         result.waterRecovered = waterContent * WATER_RECOVERY_RATE;
@@ -409,7 +418,7 @@ int main() {
     
     for (int i = 0; i < containerCount; i++) {
         string id, zone;
-        int width, depth, height;
+        double width, depth, height;
         
         cout << "\nEnter container " << i+1 << " details:" << endl;
         cout << "ID: ";
@@ -424,7 +433,7 @@ int main() {
         cout << "Height: ";
         cin >> height;
         
-        optimizer.addContainer(Container(id, zone, width, depth, height));
+        optimizer.addContainer(Container(id, zone, geom::Fixed::fromInput(width), geom::Fixed::fromInput(depth), geom::Fixed::fromInput(height)));
     }
     
     int itemCount;
@@ -433,7 +442,8 @@ int main() {
     
     for (int i = 0; i < itemCount; i++) {
         string id, name, expiryDate, preferredZone;
-        int width, depth, height, priority, usageLimit;
+        double width, depth, height;
+        int priority, usageLimit;
         double mass;
         
         cout << "\nEnter item " << i+1 << " details:" << endl;
@@ -461,14 +471,15 @@ int main() {
         cout << "Preferred Zone: ";
         getline(cin, preferredZone);
         
-        Item item(id, name, width, depth, height, mass, priority, expiryDate, usageLimit, preferredZone);
+        Item item(id, name, geom::Fixed::fromInput(width), geom::Fixed::fromInput(depth), geom::Fixed::fromInput(height),
+                  mass, priority, expiryDate, usageLimit, preferredZone);
         optimizer.addItem(item);
     }
     
     cout << "\nUpdate item positions:" << endl;
     for (int i = 0; i < itemCount; i++) {
         string itemId, containerId;
-        int x, y, z;
+        double x, y, z;
         
         cout << "Item " << i+1 << " position:" << endl;
         cout << "Item ID: ";
@@ -482,7 +493,7 @@ int main() {
         cout << "Z position: ";
         cin >> z;
         
-        optimizer.updateItemPosition(itemId, containerId, x, y, z);
+        optimizer.updateItemPosition(itemId, containerId, geom::Fixed::fromInput(x), geom::Fixed::fromInput(y), geom::Fixed::fromInput(z));
     }
     
     // Identify waste items
@@ -545,7 +556,7 @@ int main() {
     }
 
     cout << "    ]," << endl;
-    cout << "    \"totalVolume\": " << returnPlan.manifest.totalVolume << "," << endl;
+    cout << "    \"totalVolume\": " << geom::Fixed::volumeToInput(returnPlan.manifest.totalVolume) << "," << endl;
     cout << "    \"totalWeight\": " << returnPlan.manifest.totalWeight << endl;
     cout << "  }" << endl;
     cout << "}" << endl;
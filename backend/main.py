@@ -41,6 +41,9 @@ app.add_middleware(
 curr_date_iso_format = date.today().isoformat()
 curr_date = date.today()
 
+# Retrieval plans persist here between planner runs, keyed by container state
+RETRIEVAL_PLAN_CACHE = "./final_cpp_codes/retrievalPlanCache.json"
+
 @app.get("/")
 def welcome():
     return Response("Welcome")
@@ -176,7 +179,7 @@ async def placement(data: PlacementRequest):
         ]
     }, indent=4)
 
-    command = "g++ -std=c++20 ./final_cpp_codes/priorityCalculationEngine.cpp -o ./final_cpp_codes/priorityCalculationEngine && ./final_cpp_codes/priorityCalculationEngine"
+    command = "g++ -std=c++20 -O3 ./final_cpp_codes/priorityCalculationEngine.cpp -o ./final_cpp_codes/priorityCalculationEngine && ./final_cpp_codes/priorityCalculationEngine"
     process = subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True, shell=True)
     stdout, stderr = process.communicate(input=input_data)
 
@@ -402,7 +405,8 @@ async def search(data:SearchRequest):
 
     input_json = json.dumps({
         "container": container_data,
-        "itemId": itemId
+        "itemId": itemId,
+        "planCachePath": RETRIEVAL_PLAN_CACHE
     }, indent=4)
 
     command = "g++ -std=c++20 ./final_cpp_codes/retrievalPathPlanning.cpp -o ./final_cpp_codes/retrievalPathPlanning && ./final_cpp_codes/retrievalPathPlanning"
@@ -870,7 +874,8 @@ async def waste_return_plan(data: WasteReturnPlanRequest):
                 "height": container.height,
                 "items": items
             },
-            "itemId": item["itemId"]
+            "itemId": item["itemId"],
+            "planCachePath": RETRIEVAL_PLAN_CACHE
         }, indent=4)
 
         print("*" * 50, "\nInput JSON:", input_json)